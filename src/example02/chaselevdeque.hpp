@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace executor
+{
+
+// Chase-Lev work-stealing deque (the C11 formulation of Le, Pop, Cohen and Zappa Nardelli). The owning thread
+// pushes and pops at the bottom without contention; any other thread may steal from the top. The ring grows when
+// full; retired rings are kept until the deque is destroyed because a thief may still be reading one.
+template <typename T>
+class ChaseLevDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "slots are read and written as atomics");
+
+    struct Ring
+    {
+        explicit Ring(const std::size_t capacity)
+          : mask{capacity - 1}
+          , slots{std::make_unique<std::atomic<T>[]>(capacity)}
+        {
+            assert((capacity & mask) == 0);
+        }
+
+        [[nodiscard]] std::size_t
+        capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+        T
+        get(const int64_t i) const noexcept
+        {
+            return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+
+        void
+        put(const int64_t i, T value) noexcept
+        {
+            slots[static_cast<std::size_t>(i) & mask].store(value, std::memory_order_relaxed);
+        }
+
+        std::size_t                       mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+public:
+    explicit ChaseLevDeque(const std::size_t capacity = 256)
+    {
+        rings_.push_back(std::make_unique<Ring>(capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&)            = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Owner only.
+    void
+    push(T value)
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top    = top_.load(std::memory_order_acquire);
+        Ring*         ring   = ring_.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<int64_t>(ring->capacity()) - 1) {
+            ring = grow(ring, top, bottom);
+        }
+
+        ring->put(bottom, value);
+        // a release store instead of a release fence: same ordering, and one ThreadSanitizer understands
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only; LIFO end.
+    [[nodiscard]] bool
+    pop(T& result)
+    {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring*         ring   = ring_.load(std::memory_order_relaxed);
+
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        result = ring->get(bottom);
+
+        if (top == bottom) {
+            // Last element: race the thieves for it.
+            const bool won
+                = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    // Any thread; FIFO end. May fail spuriously when it loses a race, so callers treat false as "try elsewhere".
+    [[nodiscard]] bool
+    steal(T& result)
+    {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return false;
+        }
+
+        result = ring_.load(std::memory_order_acquire)->get(top);
+
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate when other threads are active.
+    [[nodiscard]] bool
+    empty() const noexcept
+    {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    Ring*
+    grow(Ring* ring, const int64_t top, const int64_t bottom)
+    {
+        auto bigger = std::make_unique<Ring>(ring->capacity() * 2);
+
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+
+        ring = bigger.get();
+        rings_.push_back(std::move(bigger));
+        ring_.store(ring, std::memory_order_release);
+
+        return ring;
+    }
+
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    alignas(kCacheLineSize) std::atomic<int64_t> top_{0};
+    alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0};
+    alignas(kCacheLineSize) std::atomic<Ring*> ring_{nullptr};
+
+    std::vector<std::unique_ptr<Ring>> rings_;  // owner only
+};
+
+}  // namespace executor
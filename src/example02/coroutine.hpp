@@ -0,0 +1,596 @@
+#pragma once
+
+#include "executor.hpp"
+#include "future.hpp"
+
+#include "example06/slaballocator.hpp"
+
+#include <asio/steady_timer.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace executor
+{
+
+template <typename T = void>
+class Task;
+
+namespace detail
+{
+// Coroutine frames of Task and co_spawn() come from one process-wide slab pool instead of the global heap.
+inline std::pmr::memory_resource&
+frameMemory()
+{
+    static SlabMemoryResource memory;
+
+    return memory;
+}
+
+struct PooledFrame
+{
+    static void*
+    operator new(const std::size_t size)
+    {
+        return frameMemory().allocate(size, alignof(std::max_align_t));
+    }
+
+    static void
+    operator delete(void* p, const std::size_t size) noexcept
+    {
+        frameMemory().deallocate(p, size, alignof(std::max_align_t));
+    }
+};
+
+// Promise of the frame at the root of a co_spawn(): nothing else owns it.
+struct RootPromise : PooledFrame
+{
+};
+
+class TaskPromiseBase : public PooledFrame
+{
+public:
+    // Symmetric transfer to the awaiting coroutine, so a chain of tasks does not grow the stack.
+    struct FinalAwaiter
+    {
+        [[nodiscard]] bool
+        await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+        {
+            const auto continuation = handle.promise().continuation_;
+
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void
+        await_resume() const noexcept
+        {
+        }
+    };
+
+    [[nodiscard]] std::suspend_always
+    initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    [[nodiscard]] FinalAwaiter
+    final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void
+    setContinuation(const std::coroutine_handle<> continuation, const std::coroutine_handle<> root) noexcept
+    {
+        continuation_ = continuation;
+        root_         = root;
+    }
+
+    [[nodiscard]] std::coroutine_handle<>
+    root() const noexcept
+    {
+        return root_;
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::coroutine_handle<> root_;
+};
+
+// The co_spawn() frame that owns the chain of tasks handle runs in, through their Task objects; null when the
+// chain is not under co_spawn().
+template <typename Promise>
+std::coroutine_handle<>
+rootOf(const std::coroutine_handle<Promise> handle) noexcept
+{
+    if constexpr (std::is_base_of_v<RootPromise, Promise>) {
+        return handle;
+    }
+    else if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>) {
+        return handle.promise().root();
+    }
+    else {
+        return nullptr;
+    }
+}
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void
+    return_value(U&& value)
+    {
+        result_.template emplace<1>(std::forward<U>(value));
+    }
+
+    void
+    unhandled_exception() noexcept
+    {
+        result_.template emplace<2>(std::current_exception());
+    }
+
+    T
+    result()
+    {
+        if (result_.index() == 2U) {
+            std::rethrow_exception(std::get<2>(result_));
+        }
+
+        return std::move(std::get<1>(result_));
+    }
+
+private:
+    std::variant<std::monostate, T, std::exception_ptr> result_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object() noexcept;
+
+    void
+    return_void() const noexcept
+    {
+    }
+
+    void
+    unhandled_exception() noexcept
+    {
+        exception_ = std::current_exception();
+    }
+
+    void
+    result() const
+    {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::exception_ptr exception_;
+};
+}  // namespace detail
+
+// Lazy coroutine: the body starts when the task is awaited (or handed to co_spawn()) and resumes the awaiting
+// coroutine when it is done. Move-only, owns its frame.
+template <typename T>
+class Task
+{
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle       = std::coroutine_handle<promise_type>;
+
+    Task(Task&& other) noexcept
+      : handle_{std::exchange(other.handle_, nullptr)}
+    {
+    }
+
+    Task&
+    operator=(Task&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+
+        return *this;
+    }
+
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        reset();
+    }
+
+    auto
+    operator co_await() && noexcept
+    {
+        return Awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+
+    struct Awaiter
+    {
+        [[nodiscard]] bool
+        await_ready() const noexcept
+        {
+            return handle.done();
+        }
+
+        // The awaiting coroutine is typed so the co_spawn() root reaches down the chain.
+        template <typename Promise>
+        std::coroutine_handle<>
+        await_suspend(const std::coroutine_handle<Promise> awaiting) const noexcept
+        {
+            handle.promise().setContinuation(awaiting, detail::rootOf(awaiting));
+
+            return handle;
+        }
+
+        T
+        await_resume() const
+        {
+            return handle.promise().result();
+        }
+
+        Handle handle;
+    };
+
+    explicit Task(const Handle handle) noexcept
+      : handle_{handle}
+    {
+    }
+
+    void
+    reset() noexcept
+    {
+        if (handle_) {
+            std::exchange(handle_, nullptr).destroy();
+        }
+    }
+
+    Handle handle_;
+};
+
+namespace detail
+{
+template <typename T>
+Task<T>
+TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+inline Task<void>
+TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+// Resumes a suspended coroutine once. Dropped without having run, e.g. with a pending timer or a queued task
+// discarded by the executor going away, it destroys the co_spawn() root instead, which frees the whole chain.
+class Resumption
+{
+public:
+    template <typename Promise>
+    explicit Resumption(const std::coroutine_handle<Promise> handle) noexcept
+      : handle_{handle}
+      , root_{rootOf(handle)}
+    {
+    }
+
+    Resumption(Resumption&& other) noexcept
+      : handle_{std::exchange(other.handle_, nullptr)}
+      , root_{std::exchange(other.root_, nullptr)}
+    {
+    }
+
+    Resumption& operator=(Resumption&&)      = delete;
+    Resumption(const Resumption&)            = delete;
+    Resumption& operator=(const Resumption&) = delete;
+
+    ~Resumption()
+    {
+        if (root_) {
+            root_.destroy();
+        }
+    }
+
+    void
+    operator()()
+    {
+        root_ = nullptr;
+        std::exchange(handle_, nullptr).resume();
+    }
+
+private:
+    std::coroutine_handle<> handle_;
+    std::coroutine_handle<> root_;
+};
+}  // namespace detail
+
+// Executor lets the awaitables and co_spawn() in through here.
+struct CoroutineAccess
+{
+    template <typename F>
+    static void
+    enqueue(Executor& executor, const Executor::Priority priority, F&& func)
+    {
+        executor.enqueue(priority, std::forward<F>(func));
+    }
+
+    template <typename F>
+    static auto
+    pooled(Executor& executor, F&& func)
+    {
+        return executor.pooled(std::forward<F>(func));
+    }
+
+    static asio::io_context&
+    ioContext(Executor& executor) noexcept
+    {
+        return executor.ioContext_;
+    }
+
+    static WatchdogManager&
+    watchdog(Executor& executor) noexcept
+    {
+        return executor.watchdogManager_;
+    }
+};
+
+// co_await executor.schedule(): the coroutine continues as a task of the executor.
+class ScheduleAwaitable
+{
+public:
+    ScheduleAwaitable(Executor& executor, const Executor::Priority priority) noexcept
+      : executor_{executor}
+      , priority_{priority}
+    {
+    }
+
+    [[nodiscard]] bool
+    await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename Promise>
+    void
+    await_suspend(const std::coroutine_handle<Promise> handle)
+    {
+        CoroutineAccess::enqueue(executor_, priority_, [resume = detail::Resumption{handle}]() mutable {
+            resume();
+        });
+    }
+
+    void
+    await_resume() const noexcept
+    {
+    }
+
+private:
+    Executor&          executor_;
+    Executor::Priority priority_;
+};
+
+// co_await executor.sleep_for(delay): waits on a steady_timer of the executor's io_context, then continues as a
+// task of the executor. The timer lives in the coroutine frame and its handler in the task memory; a handler
+// discarded with the io_context frees the frames of its co_spawn() (see detail::Resumption).
+class SleepAwaitable
+{
+public:
+    SleepAwaitable(Executor& executor, const Executor::Duration delay, const Executor::Priority priority)
+      : executor_{executor}
+      , timer_{CoroutineAccess::ioContext(executor)}
+      , delay_{delay}
+      , priority_{priority}
+    {
+    }
+
+    [[nodiscard]] bool
+    await_ready() const noexcept
+    {
+        return delay_ <= Executor::Duration::zero();
+    }
+
+    template <typename Promise>
+    void
+    await_suspend(const std::coroutine_handle<Promise> handle)
+    {
+        timer_.expires_after(delay_);
+        timer_.async_wait(CoroutineAccess::pooled(
+            executor_, [this, resume = detail::Resumption{handle}](const asio::error_code& /*errorCode*/) mutable {
+                CoroutineAccess::enqueue(executor_, priority_, [resume = std::move(resume)]() mutable {
+                    resume();
+                });
+            }));
+    }
+
+    void
+    await_resume() const noexcept
+    {
+    }
+
+private:
+    Executor&          executor_;
+    asio::steady_timer timer_;
+    Executor::Duration delay_;
+    Executor::Priority priority_;
+};
+
+namespace detail
+{
+// Root of a co_spawn(): starts on the executor, frees its frame when done.
+class DetachedTask
+{
+public:
+    struct promise_type : RootPromise
+    {
+        DetachedTask
+        get_return_object() noexcept
+        {
+            return DetachedTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        [[nodiscard]] std::suspend_always
+        initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        [[nodiscard]] std::suspend_never
+        final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void
+        return_void() const noexcept
+        {
+        }
+
+        [[noreturn]] void
+        unhandled_exception() const noexcept
+        {
+            std::terminate();  // drive() catches everything
+        }
+    };
+
+    // Resumes the coroutine once; destroys it if it never ran, e.g. with the executor going away.
+    class Start
+    {
+    public:
+        explicit Start(const std::coroutine_handle<> handle) noexcept
+          : handle_{handle}
+        {
+        }
+
+        Start(Start&& other) noexcept
+          : handle_{std::exchange(other.handle_, nullptr)}
+        {
+        }
+
+        Start& operator=(Start&&)      = delete;
+        Start(const Start&)            = delete;
+        Start& operator=(const Start&) = delete;
+
+        ~Start()
+        {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        void
+        operator()()
+        {
+            std::exchange(handle_, nullptr).resume();
+        }
+
+    private:
+        std::coroutine_handle<> handle_;
+    };
+
+    [[nodiscard]] Start
+    start() && noexcept
+    {
+        return Start{std::exchange(handle_, nullptr)};
+    }
+
+private:
+    explicit DetachedTask(const std::coroutine_handle<> handle) noexcept
+      : handle_{handle}
+    {
+    }
+
+    std::coroutine_handle<> handle_;
+};
+
+template <typename T>
+DetachedTask
+drive(Task<T> task, Promise<T> promise, Executor& executor, const WatchdogManager::Slot slot)
+{
+    try {
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+            promise.set_value();
+        }
+        else {
+            promise.set_value(co_await std::move(task));
+        }
+    }
+    catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+
+    CoroutineAccess::watchdog(executor).finishInterval(slot);
+}
+
+template <typename T>
+Future<T>
+spawn(Executor& executor, Task<T> task, const WatchdogManager::Slot slot, const Executor::Priority priority)
+{
+    Promise<T> promise{executor};
+
+    auto future = promise.get_future();
+
+    CoroutineAccess::enqueue(executor, priority, drive(std::move(task), std::move(promise), executor, slot).start());
+
+    return future;
+}
+}  // namespace detail
+
+// Runs task on the executor; its result or exception comes out of the returned future. A coroutine still suspended
+// in sleep_for() or schedule() when the executor is destroyed is not resumed; its frames are freed then.
+template <typename T>
+Future<T>
+co_spawn(Executor& executor, Task<T> task, const Executor::Priority priority = Executor::Priority::kNormal)
+{
+    return detail::spawn(executor, std::move(task), WatchdogManager::kNoSlot, priority);
+}
+
+// With a timeout the task runs under the watchdog like spawn(timeout, ...), from here until it has completed,
+// across all of its suspensions.
+template <typename T>
+Future<T>
+co_spawn(Executor&                executor,
+         const Executor::Duration timeout,
+         Task<T>                  task,
+         const Executor::Priority priority = Executor::Priority::kNormal)
+{
+    auto&      watchdog = CoroutineAccess::watchdog(executor);
+    const auto slot     = watchdog.startInterval(timeout);
+
+    try {
+        return detail::spawn(executor, std::move(task), slot, priority);
+    }
+    catch (...) {
+        // never started, so the driving coroutine does not finish the interval
+        watchdog.finishInterval(slot);
+        throw;
+    }
+}
+
+}  // namespace executor
@@ -0,0 +1,77 @@
+#include "deadlinequeue.hpp"
+
+#include <algorithm>
+
+namespace executor
+{
+
+DeadlineQueue::DeadlineQueue(const std::size_t drainers, std::pmr::memory_resource* memory)
+  : heap_{memory}
+  , maxDrainers_{std::max<std::size_t>(drainers, 1U)}
+{
+}
+
+bool
+DeadlineQueue::push(const TimePoint deadline, Task task)
+{
+    const std::lock_guard<std::mutex> lock{mutex_};
+
+    heap_.push_back(Entry{deadline, sequence_++, std::move(task)});
+    std::push_heap(heap_.begin(), heap_.end(), &DeadlineQueue::later);
+
+    if (drainers_ < maxDrainers_) {
+        ++drainers_;
+        return true;
+    }
+
+    return false;
+}
+
+std::size_t
+DeadlineQueue::push(const TimePoint deadline, std::span<Task> tasks)
+{
+    const std::lock_guard<std::mutex> lock{mutex_};
+
+    for (Task& task : tasks) {
+        heap_.push_back(Entry{deadline, sequence_++, std::move(task)});
+        std::push_heap(heap_.begin(), heap_.end(), &DeadlineQueue::later);
+    }
+
+    const std::size_t started = std::min(tasks.size(), maxDrainers_ - drainers_);
+    drainers_ += started;
+
+    return started;
+}
+
+bool
+DeadlineQueue::pop(Task& task)
+{
+    const std::lock_guard<std::mutex> lock{mutex_};
+
+    if (heap_.empty()) {
+        --drainers_;
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), &DeadlineQueue::later);
+    task = std::move(heap_.back().task);
+    heap_.pop_back();
+
+    return true;
+}
+
+std::size_t
+DeadlineQueue::size() const
+{
+    const std::lock_guard<std::mutex> lock{mutex_};
+
+    return heap_.size();
+}
+
+bool
+DeadlineQueue::later(const Entry& lhs, const Entry& rhs)
+{
+    return lhs.deadline != rhs.deadline ? lhs.deadline > rhs.deadline : lhs.sequence > rhs.sequence;
+}
+
+}  // namespace executor
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "smallfunction.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace executor
+{
+
+// Earliest-deadline-first queue in front of an executor backend, for the tasks that have a deadline. Like the
+// lanes of PriorityLanes it is run by a bounded number of drainers, each a task of the backend taking one task per
+// turn, here always the one with the earliest deadline (first come, first served among equal ones). A binary heap
+// under a mutex: O(log n) per push and pop, and the drainer count is kept under the same lock.
+class DeadlineQueue final
+{
+public:
+    using Task      = SmallFunction<void()>;
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    explicit DeadlineQueue(std::size_t                drainers,
+                           std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    DeadlineQueue(const DeadlineQueue&)            = delete;
+    DeadlineQueue& operator=(const DeadlineQueue&) = delete;
+    DeadlineQueue(DeadlineQueue&&)                 = delete;
+    DeadlineQueue& operator=(DeadlineQueue&&)      = delete;
+
+    ~DeadlineQueue() = default;
+
+    // True when the caller has to start a drainer for it.
+    [[nodiscard]] bool push(TimePoint deadline, Task task);
+
+    // All of tasks with one deadline, under one lock; returns how many drainers the caller has to start.
+    [[nodiscard]] std::size_t push(TimePoint deadline, std::span<Task> tasks);
+
+    // Moves the task with the earliest deadline to task. False when the queue is empty: the calling drainer has
+    // retired then.
+    [[nodiscard]] bool pop(Task& task);
+
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    struct Entry
+    {
+        TimePoint deadline;
+        uint64_t  sequence;
+        Task      task;
+    };
+
+    // std::push_heap/pop_heap build a max-heap: the greatest entry here is the earliest deadline.
+    static bool later(const Entry& lhs, const Entry& rhs);
+
+    mutable std::mutex      mutex_;
+    std::pmr::vector<Entry> heap_;
+    uint64_t                sequence_{0U};
+    std::size_t             drainers_{0U};
+    std::size_t             maxDrainers_;
+};
+
+}  // namespace executor
@@ -1,31 +1,78 @@
 #include "executor.hpp"
 
 #include <spdlog/spdlog.h>
+
+#include <algorithm>
 #include <chrono>
+#include <string>
 
 namespace executor
 {
 
+namespace
+{
+// One round of a spin-wait: lets the core know, so a hyper-thread sibling gets the pipeline meanwhile.
+void
+spinPause() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+}  // namespace
+
 Executor::PeriodicTask::PeriodicTask(Executor::PeriodicTask::PrivateTag,
                                      asio::io_context& ioContext,
                                      Duration          period,
                                      Func              func,
-                                     WatchdogManager*  watchdogManager)
+                                     const Config&     config)
   : ioContext_{ioContext}
   , timer_{ioContext}
   , func_{std::move(func)}
   , period_{period}
   , stopped_{true}
-  , watchdogManager_{watchdogManager}
-  , watchDog_{watchdogManager != nullptr
+  , watchdogManager_{config.watchdog}
+  , watchDog_{config.watchdog != nullptr
                   ? std::make_shared<PeriodicWatchdog>(
                         std::chrono::duration_cast<std::chrono::nanoseconds>(period * kMaxWatchdogDeviationRatio))
                   : nullptr}
+  , homeContext_{config.homeContext}
+  , wheel_{config.wheel}
+  , wheelTimer_{&PeriodicTask::onWheelTimer, this}
+  , executor_{config.executor}
+  , priority_{config.priority}
+  , metrics_{config.metrics}
+  , schedule_{config.highResolution && config.schedule == PeriodicSchedule::kRelative ? PeriodicSchedule::kSkip
+                                                                                        : config.schedule}
+  , maxBurst_{config.maxBurst}
+  , highResolution_{config.highResolution}
+  , thread_{highResolution_ ? std::make_unique<WorkerThread>() : nullptr}
+{
+}
+
+Executor::PeriodicTask::PeriodicTask(Executor::PeriodicTask::PrivateTag tag,
+                                     asio::io_context&                   ioContext,
+                                     Duration                            period,
+                                     Func                                func)
+  : PeriodicTask{tag, ioContext, period, std::move(func), Config{}}
 {
 }
 
 Executor::PeriodicTask::~PeriodicTask()
 {
+    if (thread_) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+
+            stopped_.store(true);
+        }
+
+        wakeup_.notify_all();
+        thread_.reset();
+    }
+
     try {
         if (watchdogManager_ != nullptr) {
             watchdogManager_->unregisterWatchdog(watchDog_);
@@ -47,8 +94,41 @@ Executor::PeriodicTask::start(Duration delay)
             watchdogManager_->registerWatchdog(watchDog_);
         }
 
+        if (homeContext_ != nullptr) {
+            std::lock_guard<std::mutex> lock{mutex_};
+
+            homeWork_.emplace(homeContext_->get_executor());
+        }
+
+        if (thread_) {
+            thread_->wait();  // the loop of an earlier start() has seen the stop
+            thread_->start([this, deadline = Clock::now() + delay]() {
+                applyThreadConfig(highResolution_->thread);
+                runPrecisely(deadline);
+            });
+
+            return;
+        }
+
+        if (wheel_ != nullptr) {
+            asio::dispatch(wheel_->executor(), [this, delay, self = shared_from_this()]() mutable {
+                // A stop() that came in before this ran wins.
+                if (!stopped_.load()) {
+                    self_     = std::move(self);
+                    deadline_ = Clock::now() + delay;
+                    wheel_->schedule(wheelTimer_, delay);
+                }
+            });
+
+            return;
+        }
+
         asio::post(ioContext_, [this, delay, self = shared_from_this()]() {
+            std::lock_guard<std::mutex> lock{mutex_};
+
             timer_.expires_from_now(delay);
+            deadline_ = timer_.expiry();
+
             timer_.async_wait([this, self = shared_from_this()](const asio::error_code& errorCode) {
                 execute(errorCode);
             });
@@ -71,7 +151,20 @@ Executor::PeriodicTask::stop()
 
         std::lock_guard<std::mutex> lock{mutex_};
 
-        timer_.cancel();
+        if (thread_) {
+            wakeup_.notify_all();
+        }
+        else if (wheel_ != nullptr) {
+            asio::dispatch(wheel_->executor(), [this, self = shared_from_this()]() {
+                wheel_->cancel(wheelTimer_);
+                self_.reset();
+            });
+        }
+        else {
+            timer_.cancel();
+        }
+
+        homeWork_.reset();
     }
     else {
         spdlog::warn("Executor::PeriodicTask: already stopped");
@@ -81,6 +174,28 @@ Executor::PeriodicTask::stop()
 void
 Executor::PeriodicTask::runNow()
 {
+    if (thread_) {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+
+            runNow_.store(true);
+        }
+
+        wakeup_.notify_all();
+
+        return;
+    }
+
+    if (wheel_ != nullptr) {
+        asio::dispatch(wheel_->executor(), [this, self = shared_from_this()]() {
+            if (wheelTimer_.scheduled()) {
+                wheel_->schedule(wheelTimer_, Duration{0});
+            }
+        });
+
+        return;
+    }
+
     std::lock_guard<std::mutex> lock{mutex_};
 
     if (timer_.expires_at(TimePoint::min()) != 0U) {
@@ -102,54 +217,299 @@ Executor::PeriodicTask::execute(const asio::error_code& errorCode)
 
         const auto start = Clock::now();
 
-        if (expire != std::chrono::steady_clock::time_point::min()) {
-            const auto deviation = start - expire;
-
-            if (deviation > period_ * kMaxExecuteDeviationRatio) {
-                spdlog::warn("Executor::PeriodicTask: time deviation {} us",
-                             std::chrono::duration_cast<std::chrono::microseconds>(deviation).count());
-            }
-        }
+        // runNow() expires the timer at TimePoint::min(): on time by definition
+        started(start, expire != TimePoint::min() ? expire : start, Duration{0});
 
         if (watchDog_) {
             watchDog_->tick();
         }
 
-        func_();
+        if (executor_ != nullptr) {
+            executor_->enqueue(priority_, [this, self = shared_from_this(), start]() {
+                runAndRearm(start);
+            });
+        }
+        else {
+            runAndRearm(start);
+        }
+    }
+}
+
+void
+Executor::PeriodicTask::runAndRearm(const TimePoint start)
+{
+    func_();
+
+    const auto elapsed = Clock::now() - start;
+
+    if (metrics_ != nullptr) {
+        metrics_->periodicFinished(elapsed, period_);
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    if (stopped_.load()) {
+        return;
+    }
+
+    if (schedule_ != PeriodicSchedule::kRelative) {
+        timer_.expires_at(nextDeadline(start, start + elapsed, Duration{0}));
+    }
+    else if (timer_.expires_at() != TimePoint::min()) {
+        timer_.expires_from_now(std::clamp(period_ - elapsed, Duration{0}, period_));
+    }
+    else {
+        timer_.expires_from_now(Duration{0});
+    }
+
+    timer_.async_wait([this, self = shared_from_this()](const asio::error_code& ec) {
+        execute(ec);
+    });
+}
 
-        const auto elapsed = Clock::now() - start;
+void
+Executor::PeriodicTask::runPrecisely(const TimePoint deadline)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        deadline_ = deadline;
+        burst_    = 0U;
+    }
+
+    const auto interrupted = [this]() {
+        return stopped_.load(std::memory_order_relaxed) || runNow_.load(std::memory_order_relaxed);
+    };
+
+    while (!stopped_.load()) {
+        TimePoint due;
 
         {
-            std::lock_guard<std::mutex> lock{mutex_};
+            std::unique_lock<std::mutex> lock{mutex_};
 
-            if (stopped_.load()) {
-                return;
-            }
+            due = deadline_;
 
-            expire = timer_.expires_at();
+            // the sleep ends late by up to the timer slack of the thread, the spin below takes over from there
+            wakeup_.wait_until(lock, due - highResolution_->spinMargin, interrupted);
+        }
 
-            if (expire != TimePoint::min()) {
-                timer_.expires_from_now(std::clamp(period_ - elapsed, Duration{0}, period_));
-            }
-            else {
-                timer_.expires_from_now(Duration{0});
-            }
+        while (Clock::now() < due && !interrupted()) {
+            spinPause();
+        }
+
+        if (stopped_.load()) {
+            return;
+        }
+
+        runNow_.store(false);
+
+        const auto start = Clock::now();
+
+        started(start, std::min(start, due), Duration{0});
 
-            timer_.async_wait([this, self = shared_from_this()](const asio::error_code& ec) {
-                execute(ec);
+        if (watchDog_) {
+            watchDog_->tick();
+        }
+
+        try {
+            func_();
+        }
+        catch (...) {
+            // like the exception of a timer-driven task: stops the executor and comes out of its run()
+            asio::post(ioContext_, [error = std::current_exception()]() {
+                std::rethrow_exception(error);
             });
+
+            stop();
+
+            return;
         }
+
+        const auto now = Clock::now();
+
+        if (metrics_ != nullptr) {
+            metrics_->periodicFinished(now - start, period_);
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        nextDeadline(start, now, Duration{0});
+    }
+}
+
+void
+Executor::PeriodicTask::onWheelTimer(void* context, const bool fired)
+{
+    auto* task = static_cast<PeriodicTask*>(context);
+
+    if (fired) {
+        task->executeOnWheel();
+    }
+    else {
+        task->self_.reset();  // the wheel is going away
+    }
+}
+
+void
+Executor::PeriodicTask::executeOnWheel()
+{
+    // func_ may stop the task, which drops self_.
+    const std::shared_ptr<PeriodicTask> self = self_;
+
+    const auto start = Clock::now();
+
+    // The wheel fires on tick boundaries, so up to one tick late is on time.
+    started(start, wheel_->expiry(wheelTimer_), wheel_->tick());
+
+    if (watchDog_) {
+        watchDog_->tick();
+    }
+
+    // Off the strand, so a slow func does not hold up the other timers of the wheel; the re-arm goes back to it.
+    auto run = [this, self, start]() {
+        func_();
+
+        asio::dispatch(wheel_->executor(), [this, self, start]() {
+            rearmOnWheel(start);
+        });
+    };
+
+    if (executor_ != nullptr) {
+        executor_->enqueue(priority_, std::move(run));
+    }
+    else {
+        asio::post(ioContext_, std::move(run));
+    }
+}
+
+void
+Executor::PeriodicTask::rearmOnWheel(const TimePoint start)
+{
+    // A stop() from another thread has its cancel queued behind this on the strand.
+    if (stopped_.load()) {
+        return;
+    }
+
+    const auto elapsed = Clock::now() - start;
+
+    if (metrics_ != nullptr) {
+        metrics_->periodicFinished(elapsed, period_);
+    }
+
+    if (schedule_ != PeriodicSchedule::kRelative) {
+        const auto now = start + elapsed;
+
+        wheel_->schedule(wheelTimer_, std::max(nextDeadline(start, now, wheel_->tick()) - now, Duration{0}));
+    }
+    else {
+        wheel_->schedule(wheelTimer_, std::clamp(period_ - elapsed, Duration{0}, period_));
+    }
+}
+
+Executor::TimePoint
+Executor::PeriodicTask::nextDeadline(const TimePoint start, const TimePoint now, const Duration tolerance)
+{
+    if (start + tolerance < deadline_) {
+        return deadline_;
+    }
+
+    const auto next = deadline_ + period_;
+
+    if (next > now) {
+        burst_ = 0U;
+    }
+    else if (schedule_ == PeriodicSchedule::kCatchUp && burst_ < maxBurst_) {
+        ++burst_;  // next is due already: runs right away
+    }
+    else {
+        // the last deadline that is due by now
+        const auto due = next + (now - next) / period_ * period_;
+
+        burst_ = 0U;
+
+        deadline_ = schedule_ == PeriodicSchedule::kCoalesce ? due : due + period_;
+
+        return deadline_;
+    }
+
+    deadline_ = next;
+
+    return deadline_;
+}
+
+void
+Executor::PeriodicTask::started(const TimePoint start, const TimePoint expiry, const Duration tolerance)
+{
+    const auto deviation = start - expiry;
+
+    if (metrics_ != nullptr) {
+        metrics_->periodicStarted(deviation);
+    }
+    else if (deviation > period_ * kMaxExecuteDeviationRatio && deviation > tolerance) {
+        spdlog::warn("Executor::PeriodicTask: time deviation {} us",
+                     std::chrono::duration_cast<std::chrono::microseconds>(deviation).count());
     }
 }
 
 Executor::Executor()
-  : signalSet_{ioContext_}
+  : Executor{Options{}}
+{
+}
+
+Executor::Executor(const Options& options)
+  : watchdogManager_{options.watchdogSlots}
+  , ioContext_{options.backend == Backend::kSharded ? 1 : ASIO_CONCURRENCY_HINT_DEFAULT}
+  , scheduler_{options.backend == Backend::kWorkStealing
+                   ? std::make_unique<WorkStealingScheduler>(ioContext_, options.injectionQueueCapacity, &taskMemory_)
+                   : nullptr}
+  , lanes_{options.priorityLanes
+               ? std::make_unique<PriorityLanes>(options.injectionQueueCapacity,
+                                                 options.laneDrainers != 0U ? options.laneDrainers
+                                                                            : std::thread::hardware_concurrency(),
+                                                 options.laneWeights,
+                                                 &taskMemory_)
+               : nullptr}
+  , deadlines_{options.earliestDeadlineFirst
+                   ? std::make_unique<DeadlineQueue>(options.laneDrainers != 0U ? options.laneDrainers
+                                                                                : std::thread::hardware_concurrency(),
+                                                     &taskMemory_)
+                   : nullptr}
+  , metrics_{options.metrics ? std::make_unique<ExecutorMetrics>() : nullptr}
+  , dropExpired_{options.dropExpired}
+  , periodicSchedule_{options.periodicSchedule}
+  , periodicBurst_{options.periodicBurst}
+  , ioThreads_{std::max<size_t>(std::thread::hardware_concurrency(), 1U)}
+  , signalSet_{ioContext_}
   , running_{false}
 {
+    if (options.backend == Backend::kSharded) {
+        const size_t count = options.shardsCount != 0U ? options.shardsCount
+                                                       : std::max<size_t>(std::thread::hardware_concurrency(), 1U);
+
+        // Concurrency hint 1: every shard is run by exactly one thread.
+        for (size_t i{1U}; i < count; ++i) {
+            shards_.push_back(std::make_unique<asio::io_context>(1));
+        }
+    }
+
+    if (options.periodicTimer == PeriodicTimer::kTimerWheel) {
+        for (size_t i{0U}; i < shardsCount(); ++i) {
+            wheels_.push_back(std::make_unique<TimerWheel>(shard(i), options.timerWheelTick));
+        }
+    }
 }
 
 void
 Executor::run(const size_t threadsCount, std::initializer_list<int> signals)
+{
+    RunConfig config;
+    config.threadsCount = threadsCount;
+
+    run(config, signals);
+}
+
+void
+Executor::run(const RunConfig& config, std::initializer_list<int> signals)
 {
     bool expected{false};
 
@@ -161,6 +521,8 @@ Executor::run(const size_t threadsCount, std::initializer_list<int> signals)
 
     spdlog::info("Executor: Started");
 
+    std::vector<asio::executor_work_guard<asio::io_context::executor_type>> shardsWork;
+
     try {
         for (const int signal : signals) {
             signalSet_.add(signal);
@@ -168,43 +530,91 @@ Executor::run(const size_t threadsCount, std::initializer_list<int> signals)
 
         storedException_ = nullptr;
 
-        for (size_t i{0U}; i < threadsCount; ++i) {
-            threads_.emplace_back([this]() {
+        std::vector<WorkerThread::Job> jobs;
+
+        const auto guarded = [this](auto body) {
+            return [this, body]() {
                 try {
-                    ioContext_.run();
+                    body();
                 }
                 catch (const std::exception& e) {
                     spdlog::error("Executor: Exception detected: {}", e.what());
 
-                    ioContext_.stop();
+                    stop();
 
                     spdlog::info("Executor: Stopped");
 
                     storeException();
                 }
-            });
+            };
+        };
+
+        if (scheduler_) {
+            // A stopped executor runs nothing until restart(), whichever backend queued the work.
+            if (!ioContext_.stopped()) {
+                const size_t workersCount = std::max<size_t>(config.threadsCount, 1U);
+
+                scheduler_->prepare(workersCount);
+
+                for (size_t i{0U}; i < workersCount; ++i) {
+                    jobs.emplace_back(guarded([this, i]() {
+                        scheduler_->run(i);
+                    }));
+                }
+            }
+        }
+        else if (!shards_.empty()) {
+            if (!ioContext_.stopped()) {
+                // A shard may run dry while others still spawn onto it, so each one is kept running until shard 0,
+                // which accounts for the tasks of all of them, is done.
+                for (auto& shard : shards_) {
+                    shard->restart();
+                    shardsWork.emplace_back(shard->get_executor());
+                }
+
+                for (auto& shard : shards_) {
+                    jobs.emplace_back(guarded([&shard]() {
+                        shard->run();
+                    }));
+                }
+            }
         }
+        else {
+            ioThreads_.store(config.threadsCount + 1U, std::memory_order_relaxed);
+
+            for (size_t i{0U}; i < config.threadsCount; ++i) {
+                jobs.emplace_back(guarded([this]() {
+                    ioContext_.run();
+                }));
+            }
+        }
+
+        startThreads(config, std::move(jobs));
 
         ioContext_.run();
     }
     catch (const std::exception& e) {
         spdlog::error("Executor: Exception detected: {}", e.what());
 
-        ioContext_.stop();
+        stop();
 
         spdlog::info("Executor: Stopped");
 
         storeException();
     }
 
+    if (scheduler_) {
+        scheduler_->stop();
+    }
+
+    shardsWork.clear();
+
+    // The threads stay parked for the next run(); waiting on an idle one returns at once.
     for (auto& thread : threads_) {
-        if (thread.joinable()) {
-            thread.join();
-        }
+        thread->wait();
     }
 
     signalSet_.clear();
-    threads_.clear();
 
     running_.store(false);
 
@@ -219,6 +629,10 @@ void
 Executor::stop()
 {
     ioContext_.stop();
+
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
 }
 
 void
@@ -238,9 +652,387 @@ Executor::stopped() const
 }
 
 std::shared_ptr<Executor::PeriodicTask>
-Executor::createPeriodicTask(const Duration period, PeriodicTask::Func func, bool useWatchdog)
+Executor::createPeriodicTask(const Duration     period,
+                             PeriodicTask::Func func,
+                             bool               useWatchdog,
+                             const Priority     priority)
+{
+    return createPeriodicTaskOn(shards_.empty() ? 0U : nextShard(), period, std::move(func), useWatchdog, priority);
+}
+
+std::shared_ptr<Executor::PeriodicTask>
+Executor::createPeriodicTask(const Duration        period,
+                             PeriodicTask::Func    func,
+                             const HighResolution& highResolution,
+                             bool                  useWatchdog)
+{
+    // homeContext: run() keeps going while the task is started
+    return PeriodicTask::create(ioContext_,
+                                period,
+                                std::move(func),
+                                PeriodicTask::Config{
+                                    .watchdog       = useWatchdog ? &watchdogManager_ : nullptr,
+                                    .homeContext    = &ioContext_,
+                                    .metrics        = metrics_.get(),
+                                    .schedule       = periodicSchedule_,
+                                    .maxBurst       = periodicBurst_,
+                                    .highResolution = highResolution,
+                                });
+}
+
+std::shared_ptr<Executor::PeriodicTask>
+Executor::createPeriodicTaskOn(const size_t       index,
+                               const Duration     period,
+                               PeriodicTask::Func func,
+                               bool               useWatchdog,
+                               const Priority     priority)
+{
+    const size_t pinned = index % shardsCount();
+
+    return PeriodicTask::create(shard(pinned),
+                                period,
+                                std::move(func),
+                                PeriodicTask::Config{
+                                    .watchdog    = useWatchdog ? &watchdogManager_ : nullptr,
+                                    .homeContext = pinned != 0U ? &ioContext_ : nullptr,
+                                    .wheel       = wheels_.empty() ? nullptr : wheels_[pinned].get(),
+                                    .executor    = lanes_ && priority != Priority::kCritical ? this : nullptr,
+                                    .priority    = priority,
+                                    .metrics     = metrics_.get(),
+                                    .schedule    = periodicSchedule_,
+                                    .maxBurst    = periodicBurst_,
+                                });
+}
+
+void
+Executor::execute(Task task)
+{
+    enqueue(Priority::kNormal, std::move(task));
+}
+
+std::pmr::memory_resource*
+Executor::memory() noexcept
+{
+    return &taskMemory_;
+}
+
+MetricsSnapshot
+Executor::metrics() const
+{
+    return metrics_ ? metrics_->snapshot() : MetricsSnapshot{};
+}
+
+size_t
+Executor::shardsCount() const
+{
+    return shards_.size() + 1U;
+}
+
+std::vector<Executor::Task>&
+Executor::batchTasks()
+{
+    thread_local std::vector<Task> tasks;
+
+    // left over only by a batch whose callables threw while being copied
+    tasks.clear();
+
+    return tasks;
+}
+
+void
+Executor::enqueueBatch(const Priority priority, std::vector<Task>& tasks, const std::optional<TimePoint> due)
+{
+    const auto clear = [&tasks](void*) {
+        tasks.clear();
+    };
+
+    const std::unique_ptr<void, decltype(clear)> onExit{this, clear};
+
+    if (metrics_) {
+        metrics_->queued(tasks.size());
+    }
+
+    if (due && deadlines_) {
+        for (size_t drainers = deadlines_->push(*due, tasks); drainers > 0U; --drainers) {
+            scheduleTask([this]() {
+                drainDeadlines();
+            });
+        }
+    }
+    else if (lanes_) {
+        for (size_t drainers = lanes_->push(priority, tasks); drainers > 0U; --drainers) {
+            scheduleTask([this]() {
+                drainLanes();
+            });
+        }
+    }
+    else if (scheduler_) {
+        scheduler_->postBatch(tasks);
+    }
+    else if (!shards_.empty()) {
+        // round-robin as with single tasks: shard first + i gets tasks i, i + n, i + 2n, ...
+        const size_t count = shardsCount();
+        const size_t first = nextShard_.fetch_add(tasks.size(), std::memory_order_relaxed);
+
+        for (size_t i{0U}; i < std::min(count, tasks.size()); ++i) {
+            const size_t shard = (first + i) % count;
+            TaskSlice    slice{*this, shard};
+
+            for (size_t j{i}; j < tasks.size(); j += count) {
+                slice.push(std::move(tasks[j]));
+            }
+
+            scheduleOn(shard, std::move(slice));
+        }
+    }
+    else {
+        // consecutive runs of tasks, so that one thread still runs the batch in order
+        const size_t slices = std::min(ioThreads_.load(std::memory_order_relaxed), tasks.size());
+
+        for (size_t i{0U}, begin{0U}; i < slices; ++i) {
+            const size_t end = (i + 1U) * tasks.size() / slices;
+            TaskSlice    slice{*this, 0U};
+
+            for (; begin < end; ++begin) {
+                slice.push(std::move(tasks[begin]));
+            }
+
+            scheduleOn(0U, std::move(slice));
+        }
+    }
+}
+
+Executor::TaskSlice::TaskSlice(Executor& executor, const size_t shard) noexcept
+  : executor_{&executor}
+  , shard_{shard}
+{
+}
+
+Executor::TaskSlice::TaskSlice(TaskSlice&& other) noexcept
+  : executor_{other.executor_}
+  , shard_{other.shard_}
+  , head_{std::exchange(other.head_, nullptr)}
+  , tail_{std::exchange(other.tail_, nullptr)}
+{
+}
+
+Executor::TaskSlice::~TaskSlice()
 {
-    return PeriodicTask::create(ioContext_, period, std::move(func), useWatchdog ? &watchdogManager_ : nullptr);
+    while (head_ != nullptr) {
+        deleteNode(pop());
+    }
+}
+
+void
+Executor::TaskSlice::push(Task task)
+{
+    Node* node = std::pmr::polymorphic_allocator<Node>{&executor_->taskMemory_}.new_object<Node>(std::move(task));
+
+    (tail_ != nullptr ? tail_->next : head_) = node;
+    tail_                                    = node;
+}
+
+void
+Executor::TaskSlice::operator()()
+{
+    try {
+        while (head_ != nullptr) {
+            if (executor_->shard(shard_).stopped()) {
+                executor_->scheduleOn(shard_, std::move(*this));
+                return;
+            }
+
+            Node*      node    = pop();
+            const auto release = [this, node](void*) {
+                deleteNode(node);
+            };
+
+            const std::unique_ptr<void, decltype(release)> onExit{this, release};
+
+            node->task();
+        }
+    }
+    catch (...) {
+        if (head_ != nullptr) {
+            executor_->scheduleOn(shard_, std::move(*this));
+        }
+
+        throw;
+    }
+}
+
+Executor::TaskSlice::Node*
+Executor::TaskSlice::pop() noexcept
+{
+    Node* node = std::exchange(head_, head_->next);
+
+    if (head_ == nullptr) {
+        tail_ = nullptr;
+    }
+
+    return node;
+}
+
+void
+Executor::TaskSlice::deleteNode(Node* node) noexcept
+{
+    std::pmr::polymorphic_allocator<Node>{&executor_->taskMemory_}.delete_object(node);
+}
+
+Executor::Batch*
+Executor::startBatch(const Duration timeout)
+{
+    Batch* batch = std::pmr::polymorphic_allocator<Batch>{&taskMemory_}.new_object<Batch>();
+
+    batch->slot = watchdogManager_.startInterval(timeout);
+    batch->due  = deadlineAfter(timeout);
+
+    return batch;
+}
+
+void
+Executor::launchBatch(const Priority priority, Batch* batch, std::vector<Task>& tasks)
+{
+    if (tasks.empty()) {
+        batch->remaining.store(1U, std::memory_order_relaxed);
+        finishBatch(batch);
+        return;
+    }
+
+    batch->remaining.store(tasks.size(), std::memory_order_relaxed);
+
+    enqueueBatch(priority, tasks, batch->due);
+}
+
+void
+Executor::finishBatch(Batch* batch)
+{
+    if (batch->remaining.fetch_sub(1U, std::memory_order_acq_rel) != 1U) {
+        return;
+    }
+
+    watchdogManager_.finishInterval(batch->slot);
+
+    if (batch->promise) {
+        if (batch->exception) {
+            batch->promise->set_exception(batch->exception);
+        }
+        else {
+            batch->promise->set_value();
+        }
+    }
+
+    std::pmr::polymorphic_allocator<Batch>{&taskMemory_}.delete_object(batch);
+}
+
+void
+Executor::drainLanes()
+{
+    PriorityLanes::Task* task = lanes_->pop();
+
+    // Also when the task throws: the exception leaves run(), the drainer stays queued for the next one.
+    const auto finish = [this, task](void*) {
+        lanes_->finish(task);
+
+        if (lanes_->next()) {
+            scheduleTask([this]() {
+                drainLanes();
+            });
+        }
+    };
+
+    const std::unique_ptr<void, decltype(finish)> onExit{this, finish};
+
+    if (task != nullptr) {
+        (*task)();
+    }
+}
+
+void
+Executor::drainDeadlines()
+{
+    DeadlineQueue::Task task;
+
+    if (!deadlines_->pop(task)) {
+        return;
+    }
+
+    // Also when the task throws: the exception leaves run(), the drainer stays queued for the next one.
+    const auto next = [this](void*) {
+        scheduleTask([this]() {
+            drainDeadlines();
+        });
+    };
+
+    const std::unique_ptr<void, decltype(next)> onExit{this, next};
+
+    task();
+}
+
+Executor::TimePoint
+Executor::deadlineAfter(const Duration timeout)
+{
+    const TimePoint now = Clock::now();
+
+    // a timeout of Duration::max() and the like: no deadline rather than an overflow
+    return timeout < TimePoint::max() - now ? now + timeout : TimePoint::max();
+}
+
+std::shared_ptr<Executor::Cancellation>
+Executor::cancelAt(const TimePoint due)
+{
+    auto cancellation =
+        std::allocate_shared<Cancellation>(std::pmr::polymorphic_allocator<Cancellation>{&taskMemory_}, ioContext_);
+
+    cancellation->timer.expires_at(due);
+    cancellation->timer.async_wait(pooled([cancellation](const asio::error_code& errorCode) {
+        if (!errorCode) {
+            cancellation->source.request_stop();
+        }
+    }));
+
+    return cancellation;
+}
+
+void
+Executor::finishDeadline(const Deadline& deadline)
+{
+    watchdogManager_.finishInterval(deadline.slot);
+}
+
+void
+Executor::finishDeadline(const CancellableDeadline& deadline)
+{
+    // the timer handler holds the last reference then
+    deadline.cancellation->timer.cancel();
+
+    finishDeadline(static_cast<const Deadline&>(deadline));
+}
+
+bool
+Executor::expired(const TimePoint due)
+{
+    if (!dropExpired_ || Clock::now() <= due) {
+        return false;
+    }
+
+    if (metrics_) {
+        metrics_->dropped();
+    }
+
+    return true;
+}
+
+size_t
+Executor::nextShard()
+{
+    return nextShard_.fetch_add(1U, std::memory_order_relaxed) % shardsCount();
+}
+
+asio::io_context&
+Executor::shard(const size_t index)
+{
+    return index == 0U ? ioContext_ : *shards_[index - 1U];
 }
 
 void
@@ -264,6 +1056,31 @@ Executor::stopWatchdogTask()
     }
 }
 
+void
+Executor::startThreads(const RunConfig& config, std::vector<WorkerThread::Job> jobs)
+{
+    for (size_t i{0U}; i < jobs.size(); ++i) {
+        // The stack size is fixed when a thread is created, everything else is applied again on every run.
+        if (i == threads_.size()) {
+            threads_.push_back(std::make_unique<WorkerThread>(config.stackSize));
+        }
+        else if (threads_[i]->stackSize() != config.stackSize) {
+            threads_[i] = std::make_unique<WorkerThread>(config.stackSize);
+        }
+
+        ThreadConfig threadConfig = i < config.threads.size() ? config.threads[i] : ThreadConfig{};
+
+        if (threadConfig.name.empty()) {
+            threadConfig.name = "executor-" + std::to_string(i);
+        }
+
+        threads_[i]->start([threadConfig = std::move(threadConfig), job = std::move(jobs[i])]() {
+            applyThreadConfig(threadConfig);
+            job();
+        });
+    }
+}
+
 void
 Executor::storeException()
 {
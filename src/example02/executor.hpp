@@ -1,18 +1,36 @@
 #pragma once
 
+#include "deadlinequeue.hpp"
+#include "future.hpp"
+#include "metrics.hpp"
+#include "pooledhandler.hpp"
+#include "prioritylanes.hpp"
+#include "smallfunction.hpp"
+#include "timerwheel.hpp"
 #include "watchdog.hpp"
+#include "workerthread.hpp"
+#include "workstealingscheduler.hpp"
 
+#include <asio/dispatch.hpp>
+#include <asio/executor_work_guard.hpp>
 #include <asio/io_context.hpp>
 #include <asio/post.hpp>
 #include <asio/signal_set.hpp>
 #include <asio/steady_timer.hpp>
-#include <asio/use_future.hpp>
+
+#include "example06/slaballocator.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -20,24 +38,148 @@
 namespace executor
 {
 
-class Executor
+class ExecutorScheduler;
+class ScheduleAwaitable;
+class SleepAwaitable;
+struct CoroutineAccess;
+
+// Result of a posted or submitted task that was dropped unrun past its deadline (see Options::dropExpired).
+class DeadlineExceeded final : public std::runtime_error
+{
+public:
+    DeadlineExceeded()
+      : std::runtime_error{"executor: task dropped past its deadline"}
+    {
+    }
+};
+
+class Executor : public ITaskExecutor
 {
 public:
     using Clock     = std::chrono::steady_clock;
     using TimePoint = Clock::time_point;
     using Duration  = Clock::duration;
 
+    // A spawned, posted or submitted func may take a std::stop_token (see "Deadlines" at spawn()); TaskResult is
+    // what it returns then.
+    template <typename F>
+    static constexpr bool kTakesStopToken = std::is_invocable_v<std::decay_t<F>&, std::stop_token>;
+
+    template <typename F>
+    using TaskResult = typename std::conditional_t<kTakesStopToken<F>,
+                                                   std::invoke_result<std::decay_t<F>&, std::stop_token>,
+                                                   std::invoke_result<std::decay_t<F>&>>::type;
+
+    // kAsio runs every task on the io_context, i.e. through asio's single locked handler queue. kWorkStealing runs
+    // spawned/posted tasks on a WorkStealingScheduler; the thread calling run() keeps driving the io_context for
+    // timers, periodic tasks and signals. kSharded gives every thread an io_context of its own (concurrency hint 1):
+    // tasks and periodic tasks are pinned to a shard, round-robin or explicitly, so a timer, its handler and its data
+    // stay on one thread. Shard 0 is the io_context run by the caller of run(), which also handles the signals.
+    enum class Backend
+    {
+        kAsio,
+        kWorkStealing,
+        kSharded,
+    };
+
+    // With Options::priorityLanes every spawned, posted and submitted task waits in the lane of its priority and
+    // the lanes are drained by a bounded number of tasks of the backend, higher lanes first (see PriorityLanes).
+    // Without lanes the priority is ignored.
+    using Priority    = PriorityLanes::Priority;
+    using LaneWeights = PriorityLanes::Weights;
+
+    // Placement of the threads started by run(); the calling thread is left as it is. Thread i uses threads[i]
+    // when present, and is named "executor-<i>" unless that entry names it.
+    struct RunConfig
+    {
+        size_t                    threadsCount{0U};
+        std::vector<ThreadConfig> threads;
+        size_t                    stackSize{0U};  // 0 keeps the default
+    };
+
+    // High-resolution PeriodicTask: a thread of its own sleeps until spinMargin before each deadline, then spins
+    // on steady_clock up to it and runs func right there, instead of waking through the io_context. Meant for
+    // sub-millisecond periods on a pinned (isolated) CPU; the thread keeps that CPU busy for spinMargin per period.
+    struct HighResolution
+    {
+        Duration     spinMargin{std::chrono::microseconds{100}};  // covers the wake-up latency of a sleep
+        ThreadConfig thread{};
+    };
+
+    // kSteadyTimer gives every PeriodicTask an asio::steady_timer of its own. kTimerWheel puts them on one
+    // TimerWheel per shard instead: re-arming is O(1) and allocation-free, at the price of timerWheelTick
+    // resolution. The wheel only times the runs: func is posted to the shard's io_context (or its lane), so the
+    // tasks of one wheel still run concurrently.
+    enum class PeriodicTimer
+    {
+        kSteadyTimer,
+        kTimerWheel,
+    };
+
+    // How a PeriodicTask is re-armed after a run. kRelative waits period minus the run time, so dispatch latency
+    // accumulates as drift. The others keep absolute deadlines, next = previous deadline + period, and hold the
+    // phase; they differ when a run ends past the next deadline. kSkip drops the missed ticks and waits for the next
+    // one in phase, kCatchUp runs the missed ticks back to back, at most periodicBurst in a row before dropping the
+    // rest, and kCoalesce runs once right away for all of them.
+    enum class PeriodicSchedule
+    {
+        kRelative,
+        kSkip,
+        kCatchUp,
+        kCoalesce,
+    };
+
+    struct Options
+    {
+        Backend          backend{Backend::kAsio};
+        size_t           injectionQueueCapacity{4096U};                  // kWorkStealing and lanes: power of two
+        size_t           shardsCount{0U};                                // kSharded: 0 means one per hardware thread
+        PeriodicTimer    periodicTimer{PeriodicTimer::kSteadyTimer};
+        Duration         timerWheelTick{std::chrono::milliseconds{1}};
+        PeriodicSchedule periodicSchedule{PeriodicSchedule::kRelative};
+        size_t           periodicBurst{4U};                              // kCatchUp: longest run of missed ticks
+        size_t           watchdogSlots{WatchdogManager::kDefaultSlots};  // tasks in flight under a spawn/post timeout
+        bool             priorityLanes{false};
+        size_t           laneDrainers{0U};                               // 0 means one per hardware thread
+        LaneWeights      laneWeights{16U, 4U, 1U};                       // turns per round of each Priority
+        bool             metrics{false};                                 // see Executor::metrics()
+        bool             dropExpired{false};                             // see "Deadlines" below
+        bool             earliestDeadlineFirst{false};                   // ditto; drainers: as laneDrainers
+    };
+
     class PeriodicTask final : public std::enable_shared_from_this<PeriodicTask>
     {
     private:
         class PrivateTag;
 
     public:
-        using Func = std::function<void()>;
-        // using Func = std::move_only_function<void()>;
+        using Func = SmallFunction<void()>;
+
+        // homeContext is set when ioContext is a shard other than the executor's own io_context: a started task
+        // then keeps homeContext busy, so Executor::run() does not return while the task is running elsewhere.
+        // With a wheel (running on ioContext) the task is timed by it instead of by a timer of its own. With an
+        // executor, func runs as a task of its priority lane instead of in the timer handler.
+        // With metrics, start deviations and overruns are recorded there instead of logged.
+        // schedule and maxBurst: see PeriodicSchedule. With highResolution the task runs on a thread of its own
+        // from start() to stop(), on absolute deadlines (kSkip unless schedule says otherwise); ioContext then only
+        // receives the exceptions of func. Do not drop the last reference to the task from func in that mode.
+        struct Config
+        {
+            WatchdogManager*              watchdog{nullptr};
+            asio::io_context*             homeContext{nullptr};
+            TimerWheel*                   wheel{nullptr};
+            Executor*                     executor{nullptr};
+            Priority                      priority{Priority::kCritical};
+            ExecutorMetrics*              metrics{nullptr};
+            PeriodicSchedule              schedule{PeriodicSchedule::kRelative};
+            size_t                        maxBurst{4U};
+            std::optional<HighResolution> highResolution{};
+        };
+
+        PeriodicTask(PrivateTag, asio::io_context& ioContext, Duration period, Func func, const Config& config);
 
-        PeriodicTask(
-            PrivateTag, asio::io_context& ioContext, Duration period, Func func, WatchdogManager* watchdog = nullptr);
+        // With a default Config; not a default argument, which could not use its member initializers in here.
+        PeriodicTask(PrivateTag tag, asio::io_context& ioContext, Duration period, Func func);
 
         PeriodicTask(const PeriodicTask&)            = delete;
         PeriodicTask(PeriodicTask&&)                 = delete;
@@ -68,6 +210,26 @@ public:
 
         void execute(const asio::error_code& errorCode);
 
+        void runAndRearm(TimePoint start);
+
+        // Loop of the high-resolution thread, first run due at deadline; returns after stop().
+        void runPrecisely(TimePoint deadline);
+
+        // Records the start of a run that was due at expiry, or logs it when too late and there are no metrics.
+        void started(TimePoint start, TimePoint expiry, Duration tolerance);
+
+        // Absolute schedules: moves deadline_ on after a run that started at start and ended at now. A run that
+        // started more than tolerance ahead of deadline_ came from runNow() and leaves it as it is.
+        TimePoint nextDeadline(TimePoint start, TimePoint now, Duration tolerance);
+
+        static void onWheelTimer(void* context, bool fired);
+
+        void executeOnWheel();
+
+        void rearmOnWheel(TimePoint start);
+
+        using WorkGuard = asio::executor_work_guard<asio::io_context::executor_type>;
+
         asio::io_context&                 ioContext_;
         std::mutex                        mutex_;
         asio::steady_timer                timer_;
@@ -76,6 +238,22 @@ public:
         std::atomic<bool>                 stopped_;
         WatchdogManager*                  watchdogManager_;
         std::shared_ptr<PeriodicWatchdog> watchDog_;
+        asio::io_context*                 homeContext_;
+        std::optional<WorkGuard>          homeWork_;
+        TimerWheel*                       wheel_;
+        TimerWheel::Timer                 wheelTimer_;
+        std::shared_ptr<PeriodicTask>     self_;  // wheel only: keeps the task alive while it is scheduled
+        Executor*                         executor_;
+        Priority                          priority_;
+        ExecutorMetrics*                  metrics_;
+        PeriodicSchedule                  schedule_;
+        size_t                            maxBurst_;
+        TimePoint                         deadline_;
+        size_t                            burst_{0U};
+        std::optional<HighResolution>     highResolution_;
+        std::unique_ptr<WorkerThread>     thread_;  // high resolution: runs runPrecisely()
+        std::condition_variable           wakeup_;  // wakes that thread early for stop() and runNow()
+        std::atomic<bool>                 runNow_{false};
 
         static constexpr float kMaxExecuteDeviationRatio{0.001F};
         static constexpr float kMaxWatchdogDeviationRatio{2.0F};
@@ -83,54 +261,366 @@ public:
 
     Executor();
 
-    virtual ~Executor() = default;
+    explicit Executor(const Options& options);
+
+    ~Executor() override = default;
 
     Executor(const Executor&)            = delete;
     Executor& operator=(const Executor&) = delete;
     Executor(Executor&&)                 = delete;
     Executor& operator=(Executor&&)      = delete;
 
+    // kAsio: threadsCount threads besides the caller run the io_context. kWorkStealing: max(threadsCount, 1)
+    // worker threads run the tasks while the caller runs the io_context. kSharded: threadsCount is ignored, the
+    // caller runs shard 0 and one thread per remaining shard runs that shard.
     void run(size_t threadsCount = 0U, std::initializer_list<int> signals = {});
 
+    // Threads are created by the first run() that needs them and reused by later runs, across stop()/restart().
+    void run(const RunConfig& config, std::initializer_list<int> signals = {});
+
+    // Deadlines: a task spawned, posted or submitted with a timeout is due to finish by its deadline, now plus
+    // timeout. A func taking a std::stop_token gets one that is stop-requested at the deadline, by a timer of the
+    // io_context, so it can give up cooperatively; a func without a timeout gets a token that never stops. With
+    // Options::dropExpired, a task whose deadline has passed before it starts is dropped unrun: post() and submit()
+    // then fail with DeadlineExceeded. With Options::earliestDeadlineFirst such tasks, batches included, wait in a
+    // DeadlineQueue and run in deadline order, ahead of the lanes and their priority, instead of in queue order.
+    template <typename F>
+    void
+    spawn(Priority priority, Duration timeout, F&& func)
+    {
+        auto            deadline = startDeadline<F>(timeout);
+        const TimePoint due      = deadline.due;
+
+        enqueue(priority, due, [this, deadline = std::move(deadline), func = std::forward<F>(func)]() mutable {
+            const auto finish = [this, &deadline](void*) {
+                finishDeadline(deadline);
+            };
+
+            const std::unique_ptr<void, decltype(finish)> onExit{this, finish};
+
+            if (!expired(deadline)) {
+                invoke(func, deadline);
+            }
+        });
+    }
+
     template <typename F>
     void
     spawn(Duration timeout, F&& func)
     {
-        auto watchDog = std::make_shared<IntervalWatchdog>(timeout);
+        spawn(Priority::kNormal, timeout, std::forward<F>(func));
+    }
 
-        watchDog->tick();
+    // Fire-and-forget without a watchdog: no registration and no shared state on the hot path.
+    template <typename F>
+    void
+    spawn(Priority priority, F&& func)
+    {
+        if constexpr (kTakesStopToken<F>) {
+            enqueue(priority, [func = std::forward<F>(func)]() mutable {
+                func(std::stop_token{});
+            });
+        }
+        else {
+            enqueue(priority, std::forward<F>(func));
+        }
+    }
 
-        watchdogManager_.registerWatchdog(watchDog);
+    template <typename F>
+    void
+    spawn(F&& func)
+    {
+        spawn(Priority::kNormal, std::forward<F>(func));
+    }
 
-        asio::post(ioContext_, [this, watchDog, func = std::forward<F>(func)]() {
-            func();
-            watchdogManager_.unregisterWatchdog(watchDog);
+    // kSharded: runs func on shard `shard % shardsCount()`. Other backends have a single shard and ignore the index.
+    template <typename F>
+    void
+    spawnOn(const size_t shard, F&& func)
+    {
+        if (shards_.empty()) {
+            scheduleTask(std::forward<F>(func));
+        }
+        else {
+            scheduleOn(shard % shardsCount(), std::forward<F>(func));
+        }
+    }
+
+    template <typename F>
+    auto
+    post(Duration timeout, F&& func) -> std::future<TaskResult<F>>
+    {
+        return post(Priority::kNormal, timeout, std::forward<F>(func));
+    }
+
+    template <typename F>
+    auto
+    post(Priority priority, Duration timeout, F&& func) -> std::future<TaskResult<F>>
+    {
+        using Result = TaskResult<F>;
+
+        auto            deadline = startDeadline<F>(timeout);
+        const TimePoint due      = deadline.due;
+
+        // The shared state of the future comes from the task memory as well.
+        std::promise<Result> promise{std::allocator_arg, std::pmr::polymorphic_allocator<Result>{&taskMemory_}};
+
+        auto future = promise.get_future();
+
+        enqueue(priority, due, [this, deadline = std::move(deadline), promise = std::move(promise),
+                                func = std::forward<F>(func)]() mutable {
+            const auto finish = [this, &deadline](void*) {
+                finishDeadline(deadline);
+            };
+
+            const std::unique_ptr<void, decltype(finish)> onExit{this, finish};
+
+            try {
+                if (expired(deadline)) {
+                    throw DeadlineExceeded{};
+                }
+
+                if constexpr (std::is_void_v<Result>) {
+                    invoke(func, deadline);
+                    promise.set_value();
+                }
+                else {
+                    promise.set_value(invoke(func, deadline));
+                }
+            }
+            catch (...) {
+                promise.set_exception(std::current_exception());
+            }
         });
+
+        return future;
     }
 
+    // Like post(), but returns an executor::Future: its shared state comes from the task memory, completion is a
+    // single atomic flag and then() chains further steps as tasks of this executor instead of blocking a thread.
     template <typename F>
     auto
-    post(Duration timeout, F&& func) -> std::future<decltype(func())>
+    submit(Priority priority, Duration timeout, F&& func) -> Future<TaskResult<F>>
     {
-        auto watchDog = std::make_shared<IntervalWatchdog>(timeout);
+        auto            deadline = startDeadline<F>(timeout);
+        const TimePoint due      = deadline.due;
+
+        Promise<TaskResult<F>> promise{*this};
+
+        auto future = promise.get_future();
+
+        enqueue(priority, due, [this, deadline = std::move(deadline), promise = std::move(promise),
+                                func = std::forward<F>(func)]() mutable {
+            const auto finish = [this, &deadline](void*) {
+                finishDeadline(deadline);
+            };
+
+            const std::unique_ptr<void, decltype(finish)> onExit{this, finish};
+
+            if (expired(deadline)) {
+                promise.set_exception(std::make_exception_ptr(DeadlineExceeded{}));
+            }
+            else if constexpr (kTakesStopToken<F>) {
+                promise.set_with(func, deadline.cancellation->source.get_token());
+            }
+            else {
+                promise.set_with(func);
+            }
+        });
 
-        watchDog->tick();
+        return future;
+    }
 
-        watchdogManager_.registerWatchdog(watchDog);
+    template <typename F>
+    auto
+    submit(Duration timeout, F&& func) -> Future<TaskResult<F>>
+    {
+        return submit(Priority::kNormal, timeout, std::forward<F>(func));
+    }
+
+    template <typename F>
+    auto
+    submit(Priority priority, F&& func) -> Future<TaskResult<F>>
+    {
+        Promise<TaskResult<F>> promise{*this};
+
+        auto future = promise.get_future();
+
+        enqueue(priority, [promise = std::move(promise), func = std::forward<F>(func)]() mutable {
+            if constexpr (kTakesStopToken<F>) {
+                promise.set_with(func, std::stop_token{});
+            }
+            else {
+                promise.set_with(func);
+            }
+        });
+
+        return future;
+    }
+
+    template <typename F>
+    auto
+    submit(F&& func) -> Future<TaskResult<F>>
+    {
+        return submit(Priority::kNormal, std::forward<F>(func));
+    }
 
-        return asio::post(
-            ioContext_, asio::use_future([this, watchDog, func = std::forward<F>(func)]() -> decltype(auto) {
-                const auto unregisterWatcgDog = [this, &watchDog](void*) {
-                    watchdogManager_.unregisterWatchdog(watchDog);
+    // Batches for fan-out: every callable of funcs (moved out of an rvalue range, copied out of an lvalue one) is
+    // enqueued in one go: with kWorkStealing one fence and a wakeup of at most as many workers as there are tasks,
+    // with kAsio one handler per thread running the io_context and with kSharded one per shard, each running its
+    // slice of the batch, and with lanes one push into the lane. With a timeout the whole batch is one watchdog
+    // interval, from here until its last task has finished.
+    template <typename Range>
+    void
+    spawnBatch(const Priority priority, Range&& funcs)
+    {
+        const auto posted = batchPosted();
+        auto&      tasks  = batchTasks();
+
+        for (auto&& func : funcs) {
+            stage(tasks, posted, element<Range>(func));
+        }
+
+        enqueueBatch(priority, tasks);
+    }
+
+    template <typename Range>
+    void
+    spawnBatch(Range&& funcs)
+    {
+        spawnBatch(Priority::kNormal, std::forward<Range>(funcs));
+    }
+
+    template <typename Range>
+    void
+    spawnBatch(const Priority priority, const Duration timeout, Range&& funcs)
+    {
+        Batch*     batch  = startBatch(timeout);
+        const auto posted = batchPosted();
+        auto&      tasks  = batchTasks();
+
+        for (auto&& func : funcs) {
+            stage(tasks, posted, [this, batch, func = element<Range>(func)]() mutable {
+                const auto finish = [this, batch](void*) {
+                    finishBatch(batch);
                 };
 
-                const std::unique_ptr<void, decltype(unregisterWatcgDog)> onExit{this, unregisterWatcgDog};
+                const std::unique_ptr<void, decltype(finish)> onExit{this, finish};
+
+                if (!expired(batch->due)) {
+                    func();
+                }
+            });
+        }
+
+        launchBatch(priority, batch, tasks);
+    }
+
+    template <typename Range>
+    void
+    spawnBatch(const Duration timeout, Range&& funcs)
+    {
+        spawnBatch(Priority::kNormal, timeout, std::forward<Range>(funcs));
+    }
+
+    // Like spawnBatch(), with one future for the whole batch: ready once every task has run, holding the exception
+    // of the first task that failed, if any. The tasks of a batch share its deadline; they do not take a stop token.
+    template <typename Range>
+    std::future<void>
+    postBatch(const Priority priority, const Duration timeout, Range&& funcs)
+    {
+        Batch* batch = startBatch(timeout);
+
+        // the shared state of the future comes from the task memory as well
+        auto& promise = batch->promise.emplace(std::allocator_arg, std::pmr::polymorphic_allocator<void>{&taskMemory_});
+        auto  future  = promise.get_future();
+
+        const auto posted = batchPosted();
+        auto&      tasks  = batchTasks();
+
+        for (auto&& func : funcs) {
+            stage(tasks, posted, [this, batch, func = element<Range>(func)]() mutable {
+                try {
+                    if (expired(batch->due)) {
+                        throw DeadlineExceeded{};
+                    }
+
+                    func();
+                }
+                catch (...) {
+                    batch->fail(std::current_exception());
+                }
+
+                finishBatch(batch);
+            });
+        }
+
+        launchBatch(priority, batch, tasks);
+
+        return future;
+    }
+
+    template <typename Range>
+    std::future<void>
+    postBatch(const Duration timeout, Range&& funcs)
+    {
+        return postBatch(Priority::kNormal, timeout, std::forward<Range>(funcs));
+    }
+
+    // stdexec scheduler of this executor (see ExecutorScheduler); needs "example02/executorscheduler.hpp".
+    template <typename Scheduler = ExecutorScheduler>
+    Scheduler
+    get_scheduler(const Priority priority = Priority::kNormal)
+    {
+        return Scheduler{*this, priority};
+    }
+
+    // Coroutine awaitables (see coroutine.hpp): co_await schedule() continues as a task of this executor,
+    // co_await sleep_for(delay) does so after delay, waiting on a timer of this executor's io_context.
+    template <typename Awaitable = ScheduleAwaitable>
+    Awaitable
+    schedule(const Priority priority = Priority::kNormal)
+    {
+        return Awaitable{*this, priority};
+    }
 
-                return func();
-            }));
+    template <typename Awaitable = SleepAwaitable>
+    Awaitable
+    sleep_for(const Duration delay, const Priority priority = Priority::kNormal)
+    {
+        return Awaitable{*this, delay, priority};
     }
 
-    std::shared_ptr<PeriodicTask> createPeriodicTask(Duration period, PeriodicTask::Func func, bool useWatchdog = true);
+    // ITaskExecutor: continuations of the futures returned by submit().
+    void execute(Task task) final;
+
+    [[nodiscard]] std::pmr::memory_resource* memory() noexcept final;
+
+    // kSharded: the task is pinned to the next shard in round-robin order. A kCritical task runs in its timer
+    // handler, as without lanes; with lanes, a lower priority hands every run to that lane, shard pinning aside.
+    std::shared_ptr<PeriodicTask> createPeriodicTask(Duration           period,
+                                                     PeriodicTask::Func func,
+                                                     bool               useWatchdog = true,
+                                                     Priority           priority    = Priority::kCritical);
+
+    // High-resolution variant (see HighResolution); func runs on the task's own thread, whatever the backend.
+    std::shared_ptr<PeriodicTask> createPeriodicTask(Duration              period,
+                                                     PeriodicTask::Func    func,
+                                                     const HighResolution& highResolution,
+                                                     bool                  useWatchdog = true);
+
+    std::shared_ptr<PeriodicTask> createPeriodicTaskOn(size_t             shard,
+                                                       Duration           period,
+                                                       PeriodicTask::Func func,
+                                                       bool               useWatchdog = true,
+                                                       Priority           priority    = Priority::kCritical);
+
+    [[nodiscard]] size_t shardsCount() const;
+
+    // Counters and histograms since construction, cheap enough to scrape from a periodic task. All zero unless
+    // Options::metrics; then every spawned, posted, submitted and batched task is timed, which costs two clock
+    // reads per task, and a task wrapping a SmallFunction no longer fits inline and is allocated.
+    [[nodiscard]] MetricsSnapshot metrics() const;
 
     void stop();
 
@@ -153,17 +643,303 @@ public:
     }
 
 private:
+    friend class ExecutorScheduler;
+    friend struct CoroutineAccess;
+
+    template <typename F>
+    void
+    enqueue(const Priority priority, F&& func)
+    {
+        enqueue(priority, std::nullopt, std::forward<F>(func));
+    }
+
+    // due: the deadline of a task with a timeout, which decides its place with Options::earliestDeadlineFirst.
+    template <typename F>
+    void
+    enqueue(const Priority priority, const std::optional<TimePoint> due, F&& func)
+    {
+        if (metrics_) {
+            metrics_->queued();
+            route(priority,
+                  due,
+                  [metrics = metrics_.get(), posted = Clock::now(), func = std::forward<F>(func)]() mutable {
+                      metrics->measure(posted, func);
+                  });
+        }
+        else {
+            route(priority, due, std::forward<F>(func));
+        }
+    }
+
+    template <typename F>
+    void
+    route(const Priority priority, const std::optional<TimePoint> due, F&& func)
+    {
+        if (due && deadlines_) {
+            if (deadlines_->push(*due, std::forward<F>(func))) {
+                scheduleTask([this]() {
+                    drainDeadlines();
+                });
+            }
+        }
+        else if (!lanes_) {
+            scheduleTask(std::forward<F>(func));
+        }
+        else if (lanes_->push(priority, std::forward<F>(func))) {
+            scheduleTask([this]() {
+                drainLanes();
+            });
+        }
+    }
+
+    template <typename F>
+    void
+    scheduleTask(F&& func)
+    {
+        if (scheduler_) {
+            scheduler_->post(std::forward<F>(func));
+        }
+        else if (!shards_.empty()) {
+            scheduleOn(nextShard(), std::forward<F>(func));
+        }
+        else {
+            asio::post(ioContext_, pooled(std::forward<F>(func)));
+        }
+    }
+
+    // A task queued on another shard counts as work of ioContext_ until it has run, so run() on shard 0 returns only
+    // when every shard is out of tasks.
+    template <typename F>
+    void
+    scheduleOn(const size_t shard, F&& func)
+    {
+        if (shard == 0U) {
+            asio::post(ioContext_, pooled(std::forward<F>(func)));
+        }
+        else {
+            asio::post(*shards_[shard - 1U],
+                       pooled([work = asio::make_work_guard(ioContext_), func = std::forward<F>(func)]() mutable {
+                           func();
+                       }));
+        }
+    }
+
+    // asio allocates the queued operation through the handler's allocator, i.e. from taskMemory_.
+    template <typename F>
+    PooledHandler<std::decay_t<F>>
+    pooled(F&& func)
+    {
+        return {std::forward<F>(func), &taskMemory_};
+    }
+
+    // Stop source of a task whose func takes a std::stop_token; a timer of ioContext_ requests the stop at the
+    // task's deadline, unless the task has finished and cancelled it by then.
+    struct Cancellation
+    {
+        explicit Cancellation(asio::io_context& ioContext)
+          : timer{ioContext}
+        {
+        }
+
+        std::stop_source   source;
+        asio::steady_timer timer;
+    };
+
+    // Watchdog slot and deadline of a task spawned, posted or submitted with a timeout.
+    struct Deadline
+    {
+        WatchdogManager::Slot slot{WatchdogManager::kNoSlot};
+        TimePoint             due{};
+    };
+
+    struct CancellableDeadline : Deadline
+    {
+        std::shared_ptr<Cancellation> cancellation;
+    };
+
+    // Starts the watchdog interval of a task with a timeout, and the cancellation when func takes a stop token.
+    template <typename F>
+    auto
+    startDeadline(const Duration timeout)
+    {
+        const Deadline deadline{watchdogManager_.startInterval(timeout), deadlineAfter(timeout)};
+
+        if constexpr (kTakesStopToken<F>) {
+            return CancellableDeadline{deadline, cancelAt(deadline.due)};
+        }
+        else {
+            return deadline;
+        }
+    }
+
+    static TimePoint deadlineAfter(Duration timeout);
+
+    std::shared_ptr<Cancellation> cancelAt(TimePoint due);
+
+    void finishDeadline(const Deadline& deadline);
+
+    void finishDeadline(const CancellableDeadline& deadline);
+
+    // With Options::dropExpired: true, and counted, when a task due at due is about to start too late.
+    [[nodiscard]] bool expired(TimePoint due);
+
+    [[nodiscard]] bool
+    expired(const Deadline& deadline)
+    {
+        return expired(deadline.due);
+    }
+
+    template <typename F, typename D>
+    static decltype(auto)
+    invoke(F& func, [[maybe_unused]] const D& deadline)
+    {
+        if constexpr (kTakesStopToken<F>) {
+            return func(deadline.cancellation->source.get_token());
+        }
+        else {
+            return func();
+        }
+    }
+
+    // Shared by the tasks of one spawnBatch()/postBatch() with a timeout; the last one to finish releases it.
+    struct Batch
+    {
+        void
+        fail(std::exception_ptr error)
+        {
+            if (!failed.test_and_set(std::memory_order_relaxed)) {
+                exception = std::move(error);
+            }
+        }
+
+        std::atomic<size_t>               remaining{0U};
+        WatchdogManager::Slot             slot{WatchdogManager::kNoSlot};
+        TimePoint                         due{TimePoint::max()};
+        std::optional<std::promise<void>> promise;
+        std::atomic_flag                  failed;
+        std::exception_ptr                exception;
+    };
+
+    // Staged tasks of one batch bound for one shard (shard 0 with kAsio), queued there as a single handler that
+    // runs them in order. The ones left when a task throws or the shard is stopped are queued again; a slice
+    // dropped unrun destroys them. Its nodes come from the task memory.
+    class TaskSlice
+    {
+    public:
+        TaskSlice(Executor& executor, size_t shard) noexcept;
+
+        TaskSlice(TaskSlice&& other) noexcept;
+
+        TaskSlice& operator=(TaskSlice&&)      = delete;
+        TaskSlice(const TaskSlice&)            = delete;
+        TaskSlice& operator=(const TaskSlice&) = delete;
+
+        ~TaskSlice();
+
+        void push(Task task);
+
+        void operator()();
+
+    private:
+        struct Node
+        {
+            Task  task;
+            Node* next{nullptr};
+        };
+
+        // Unlinks the first node; the caller deletes it.
+        Node* pop() noexcept;
+
+        void deleteNode(Node* node) noexcept;
+
+        Executor* executor_;
+        size_t    shard_;
+        Node*     head_{nullptr};
+        Node*     tail_{nullptr};
+    };
+
+    // func as an lvalue when the range is one, so that lvalue ranges are copied from and rvalue ones moved from.
+    template <typename Range, typename T>
+    static decltype(auto)
+    element(T& func)
+    {
+        if constexpr (std::is_lvalue_reference_v<Range>) {
+            return (func);
+        }
+        else {
+            return std::move(func);
+        }
+    }
+
+    // Adds func to a staged batch, timed from posted like enqueue() does with metrics.
+    template <typename F>
+    void
+    stage(std::vector<Task>& tasks, const TimePoint posted, F&& func)
+    {
+        if (metrics_) {
+            tasks.emplace_back([metrics = metrics_.get(), posted, func = std::forward<F>(func)]() mutable {
+                metrics->measure(posted, func);
+            });
+        }
+        else {
+            tasks.emplace_back(std::forward<F>(func));
+        }
+    }
+
+    [[nodiscard]] TimePoint
+    batchPosted() const
+    {
+        return metrics_ ? Clock::now() : TimePoint{};
+    }
+
+    // Per-thread staging buffer, returned empty; it keeps its capacity, so batching does not allocate.
+    static std::vector<Task>& batchTasks();
+
+    // Enqueues and clears tasks; due as for enqueue().
+    void enqueueBatch(Priority priority, std::vector<Task>& tasks, std::optional<TimePoint> due = std::nullopt);
+
+    Batch* startBatch(Duration timeout);
+
+    // Sets the task count of batch, then enqueues tasks; an empty batch finishes right away.
+    void launchBatch(Priority priority, Batch* batch, std::vector<Task>& tasks);
+
+    void finishBatch(Batch* batch);
+
+    // One turn of a lane drainer: runs the next task and queues the drainer again while the lanes have work.
+    void drainLanes();
+
+    // The same for the DeadlineQueue: runs the task with the earliest deadline, or retires once it is empty.
+    void drainDeadlines();
+
+    size_t nextShard();
+
+    asio::io_context& shard(size_t index);
+
+    void startThreads(const RunConfig& config, std::vector<WorkerThread::Job> jobs);
+
     void storeException();
 
 private:
-    WatchdogManager               watchdogManager_;
-    asio::io_context              ioContext_;
-    asio::signal_set              signalSet_;
-    std::vector<std::thread>      threads_;
-    std::mutex                    mutex_;
-    std::exception_ptr            storedException_;
-    std::shared_ptr<PeriodicTask> watchDogTask_;
-    std::atomic<bool>             running_;
+    SlabMemoryResource                             taskMemory_;  // tasks and asio handlers; outlives both
+    WatchdogManager                                watchdogManager_;
+    asio::io_context                               ioContext_;
+    std::unique_ptr<WorkStealingScheduler>         scheduler_;
+    std::unique_ptr<PriorityLanes>                 lanes_;
+    std::unique_ptr<DeadlineQueue>                 deadlines_;  // Options::earliestDeadlineFirst
+    std::unique_ptr<ExecutorMetrics>               metrics_;
+    bool                                           dropExpired_;
+    PeriodicSchedule                               periodicSchedule_;
+    size_t                                         periodicBurst_;
+    std::vector<std::unique_ptr<asio::io_context>> shards_;  // kSharded: shards 1..n-1, ioContext_ is shard 0
+    std::vector<std::unique_ptr<TimerWheel>>       wheels_;  // kTimerWheel: one per shard
+    std::atomic<size_t>                            nextShard_{0U};
+    std::atomic<size_t>                            ioThreads_;  // kAsio: threads of the last run(), for batches
+    asio::signal_set                               signalSet_;
+    std::vector<std::unique_ptr<WorkerThread>>     threads_;
+    std::mutex                                     mutex_;
+    std::exception_ptr                             storedException_;
+    std::shared_ptr<PeriodicTask>                  watchDogTask_;
+    std::atomic<bool>                              running_;
 };
 
 }  // namespace executor
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "executor.hpp"
+
+#include <asio/steady_timer.hpp>
+
+#include <stdexec/execution.hpp>
+
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace executor
+{
+
+// stdexec scheduler of an Executor, so sender pipelines (then, when_all, bulk, ...) run on the executor's threads
+// instead of on a thread pool of their own. schedule() completes as a task of the scheduler's priority, spawned
+// like any other; schedule_after()/schedule_at() wait on an asio timer of the executor's io_context first. With a
+// timeout, the executor's watchdog watches every operation from start() until its receiver returns from
+// set_value(), i.e. the work chained up to the next scheduling point. A stop request is honoured when the operation
+// completes: it then calls set_stopped() instead of set_value(); a pending timer is not cut short.
+class ExecutorScheduler
+{
+public:
+    using Clock     = Executor::Clock;
+    using TimePoint = Executor::TimePoint;
+    using Duration  = Executor::Duration;
+    using Priority  = Executor::Priority;
+
+    explicit ExecutorScheduler(Executor&               executor,
+                               Priority                priority = Priority::kNormal,
+                               std::optional<Duration> timeout  = std::nullopt) noexcept
+      : executor_{&executor}
+      , priority_{priority}
+      , timeout_{timeout}
+    {
+    }
+
+    template <typename Receiver>
+    class Operation;
+
+    class Sender;
+
+    [[nodiscard]] Sender schedule() const noexcept;
+
+    [[nodiscard]] Sender schedule_after(Duration delay) const noexcept;
+
+    [[nodiscard]] Sender schedule_at(TimePoint timePoint) const noexcept;
+
+    [[nodiscard]] TimePoint
+    now() const noexcept
+    {
+        return Clock::now();
+    }
+
+    // Same executor, other priority or watchdog timeout.
+    [[nodiscard]] ExecutorScheduler
+    with_priority(const Priority priority) const noexcept
+    {
+        return ExecutorScheduler{*executor_, priority, timeout_};
+    }
+
+    [[nodiscard]] ExecutorScheduler
+    with_timeout(const Duration timeout) const noexcept
+    {
+        return ExecutorScheduler{*executor_, priority_, timeout};
+    }
+
+    friend bool operator==(const ExecutorScheduler&, const ExecutorScheduler&) = default;
+
+private:
+    // When the timer of an operation expires; neither means no timer. A delay counts from start().
+    struct Timing
+    {
+        std::optional<TimePoint> at{};
+        std::optional<Duration>  after{};
+    };
+
+    // Executor lets its scheduler in; the nested operations go through these.
+    static WatchdogManager&
+    watchdog(Executor& executor) noexcept
+    {
+        return executor.watchdogManager_;
+    }
+
+    static asio::io_context&
+    ioContext(Executor& executor) noexcept
+    {
+        return executor.ioContext_;
+    }
+
+    template <typename F>
+    static void
+    enqueue(Executor& executor, const Priority priority, F&& func)
+    {
+        executor.enqueue(priority, std::forward<F>(func));
+    }
+
+    Executor*               executor_;
+    Priority                priority_;
+    std::optional<Duration> timeout_;
+};
+
+template <typename Receiver>
+class ExecutorScheduler::Operation
+{
+public:
+    Operation(Receiver receiver, const ExecutorScheduler& scheduler, const Timing& timing)
+      : receiver_{std::move(receiver)}
+      , scheduler_{scheduler}
+      , timing_{timing}
+    {
+    }
+
+    Operation(const Operation&)            = delete;
+    Operation& operator=(const Operation&) = delete;
+    Operation(Operation&&)                 = delete;
+    Operation& operator=(Operation&&)      = delete;
+    ~Operation()                           = default;
+
+    void
+    start() & noexcept
+    {
+        try {
+            if (scheduler_.timeout_) {
+                slot_ = watchdog(*scheduler_.executor_).startInterval(*scheduler_.timeout_);
+            }
+
+            if (timing_.at || timing_.after) {
+                timer_.emplace(ioContext(*scheduler_.executor_));
+
+                if (timing_.at) {
+                    timer_->expires_at(*timing_.at);
+                }
+                else {
+                    timer_->expires_after(*timing_.after);
+                }
+
+                timer_->async_wait([this](const asio::error_code& /*errorCode*/) {
+                    enqueue();
+                });
+            }
+            else {
+                enqueue();
+            }
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+    }
+
+private:
+    void
+    enqueue() noexcept
+    {
+        try {
+            ExecutorScheduler::enqueue(*scheduler_.executor_, scheduler_.priority_, [this]() {
+                complete();
+            });
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+    }
+
+    // The receiver may destroy this operation, so nothing of it is touched after the completion.
+    void
+    complete() noexcept
+    {
+        Executor*  executor = scheduler_.executor_;
+        const auto slot     = std::exchange(slot_, WatchdogManager::kNoSlot);
+
+        if (stdexec::get_stop_token(stdexec::get_env(receiver_)).stop_requested()) {
+            stdexec::set_stopped(std::move(receiver_));
+        }
+        else {
+            stdexec::set_value(std::move(receiver_));
+        }
+
+        if (slot != WatchdogManager::kNoSlot) {
+            watchdog(*executor).finishInterval(slot);
+        }
+    }
+
+    void
+    fail(std::exception_ptr exception) noexcept
+    {
+        Executor*  executor = scheduler_.executor_;
+        const auto slot     = std::exchange(slot_, WatchdogManager::kNoSlot);
+
+        stdexec::set_error(std::move(receiver_), std::move(exception));
+
+        if (slot != WatchdogManager::kNoSlot) {
+            watchdog(*executor).finishInterval(slot);
+        }
+    }
+
+    Receiver                          receiver_;
+    ExecutorScheduler                 scheduler_;
+    Timing                            timing_;
+    std::optional<asio::steady_timer> timer_;
+    WatchdogManager::Slot             slot_{WatchdogManager::kNoSlot};
+};
+
+class ExecutorScheduler::Sender
+{
+public:
+    using sender_concept        = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(),
+                                                                 stdexec::set_error_t(std::exception_ptr),
+                                                                 stdexec::set_stopped_t()>;
+
+    struct Env
+    {
+        [[nodiscard]] ExecutorScheduler
+        query(stdexec::get_completion_scheduler_t<stdexec::set_value_t> /*tag*/) const noexcept
+        {
+            return scheduler;
+        }
+
+        ExecutorScheduler scheduler;
+    };
+
+    Sender(const ExecutorScheduler& scheduler, const Timing& timing) noexcept
+      : scheduler_{scheduler}
+      , timing_{timing}
+    {
+    }
+
+    template <typename Receiver>
+    Operation<Receiver>
+    connect(Receiver receiver) const
+    {
+        return {std::move(receiver), scheduler_, timing_};
+    }
+
+    [[nodiscard]] Env
+    get_env() const noexcept
+    {
+        return {scheduler_};
+    }
+
+private:
+    ExecutorScheduler scheduler_;
+    Timing            timing_;
+};
+
+inline ExecutorScheduler::Sender
+ExecutorScheduler::schedule() const noexcept
+{
+    return {*this, Timing{}};
+}
+
+inline ExecutorScheduler::Sender
+ExecutorScheduler::schedule_after(const Duration delay) const noexcept
+{
+    return {*this, Timing{.after = delay}};
+}
+
+inline ExecutorScheduler::Sender
+ExecutorScheduler::schedule_at(const TimePoint timePoint) const noexcept
+{
+    return {*this, Timing{.at = timePoint}};
+}
+
+}  // namespace executor
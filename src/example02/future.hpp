@@ -0,0 +1,630 @@
+#pragma once
+
+#include "smallfunction.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace executor
+{
+
+// Runs continuations and provides the memory for the shared states of Future/Promise. Executor implements it.
+class ITaskExecutor
+{
+public:
+    using Task = SmallFunction<void()>;
+
+    virtual ~ITaskExecutor() = default;
+
+    virtual void execute(Task task) = 0;
+
+    [[nodiscard]] virtual std::pmr::memory_resource* memory() noexcept = 0;
+
+protected:
+    ITaskExecutor()                                  = default;
+    ITaskExecutor(const ITaskExecutor&)              = default;
+    ITaskExecutor& operator=(const ITaskExecutor&) & = default;
+    ITaskExecutor(ITaskExecutor&&)                   = default;
+    ITaskExecutor& operator=(ITaskExecutor&&) &      = default;
+};
+
+// Stands in for void where a value has to be stored, e.g. in the tuple of when_all().
+struct Unit
+{
+    friend bool operator==(const Unit&, const Unit&) = default;
+};
+
+template <typename T>
+class Future;
+
+template <typename T>
+class Promise;
+
+namespace detail
+{
+template <typename T>
+using ValueOf = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+template <typename T, typename F>
+using ThenResult =
+    typename std::conditional_t<std::is_void_v<T>, std::invoke_result<F&>, std::invoke_result<F&, ValueOf<T>>>::type;
+
+template <typename T>
+struct IsFuture : std::false_type
+{
+};
+
+template <typename T>
+struct IsFuture<Future<T>> : std::true_type
+{
+};
+
+// Shared by a Promise and its Future, reference counted, allocated from the memory resource of the executor.
+// Completion is one atomic word: the producer stores the result and swaps in kReady, a consumer either finds
+// kReady or parks a single callback behind kCallback, which the producer then runs. There is no mutex and no
+// condition variable; a blocking get() sleeps on the same word with atomic wait.
+template <typename T>
+class SharedState
+{
+public:
+    using Value    = ValueOf<T>;
+    using Callback = SmallFunction<void()>;
+
+    explicit SharedState(ITaskExecutor& executor)
+      : executor_{executor}
+    {
+    }
+
+    SharedState(const SharedState&)            = delete;
+    SharedState& operator=(const SharedState&) = delete;
+    SharedState(SharedState&&)                 = delete;
+    SharedState& operator=(SharedState&&)      = delete;
+    ~SharedState()                             = default;
+
+    static SharedState*
+    create(ITaskExecutor& executor)
+    {
+        std::pmr::polymorphic_allocator<SharedState> allocator{executor.memory()};
+
+        return allocator.template new_object<SharedState>(executor);
+    }
+
+    void
+    acquire() noexcept
+    {
+        refs_.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    void
+    release() noexcept
+    {
+        if (refs_.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+            std::pmr::polymorphic_allocator<SharedState> allocator{executor_.memory()};
+
+            allocator.delete_object(this);
+        }
+    }
+
+    // A throwing constructor of the value leaves the state pending.
+    template <typename... Args>
+    void
+    setValue(Args&&... args)
+    {
+        result_.template emplace<1>(std::forward<Args>(args)...);
+        complete();
+    }
+
+    void
+    setException(std::exception_ptr exception) noexcept
+    {
+        result_.template emplace<2>(std::move(exception));
+        complete();
+    }
+
+    // callback runs on the thread that completes the state, or right here when the state is complete already.
+    void
+    onReady(Callback callback) noexcept
+    {
+        callback_ = std::move(callback);
+
+        uint32_t expected{kPending};
+
+        if (!state_.compare_exchange_strong(expected, kCallback, std::memory_order_acq_rel)) {
+            std::exchange(callback_, nullptr)();
+        }
+    }
+
+    [[nodiscard]] bool
+    ready() const noexcept
+    {
+        return state_.load(std::memory_order_acquire) == kReady;
+    }
+
+    void
+    wait() const noexcept
+    {
+        auto state = state_.load(std::memory_order_acquire);
+
+        while (state != kReady) {
+            state_.wait(state, std::memory_order_acquire);
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+
+    // The accessors below are only valid once the state is ready.
+    [[nodiscard]] bool
+    failed() const noexcept
+    {
+        return result_.index() == 2U;
+    }
+
+    [[nodiscard]] std::exception_ptr
+    exception() const noexcept
+    {
+        return std::get<2>(result_);
+    }
+
+    [[nodiscard]] Value&
+    value() noexcept
+    {
+        return std::get<1>(result_);
+    }
+
+    [[nodiscard]] ITaskExecutor&
+    executor() const noexcept
+    {
+        return executor_;
+    }
+
+private:
+    static constexpr uint32_t kPending  = 0U;
+    static constexpr uint32_t kCallback = 1U;
+    static constexpr uint32_t kReady    = 2U;
+
+    void
+    complete() noexcept
+    {
+        const auto previous = state_.exchange(kReady, std::memory_order_acq_rel);
+
+        state_.notify_all();
+
+        if (previous == kCallback) {
+            std::exchange(callback_, nullptr)();
+        }
+    }
+
+    ITaskExecutor&                                          executor_;
+    std::atomic<uint32_t>                                   state_{kPending};
+    std::atomic<uint32_t>                                   refs_{1U};
+    std::variant<std::monostate, Value, std::exception_ptr> result_;
+    Callback                                                callback_;
+};
+
+template <typename T>
+struct Releaser
+{
+    void
+    operator()(SharedState<T>* state) const noexcept
+    {
+        state->release();
+    }
+};
+
+template <typename T>
+using StatePtr = std::unique_ptr<SharedState<T>, Releaser<T>>;
+
+struct FutureAccess;
+}  // namespace detail
+
+// Producer side of a Future. Destroying a promise that was never satisfied fails the future with broken_promise.
+template <typename T>
+class Promise
+{
+public:
+    explicit Promise(ITaskExecutor& executor)
+      : state_{detail::SharedState<T>::create(executor)}
+    {
+    }
+
+    Promise(Promise&& other) noexcept = default;
+
+    Promise&
+    operator=(Promise&& other) noexcept
+    {
+        if (this != &other) {
+            abandon();
+            state_     = std::move(other.state_);
+            retrieved_ = other.retrieved_;
+        }
+
+        return *this;
+    }
+
+    Promise(const Promise&)            = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    ~Promise()
+    {
+        abandon();
+    }
+
+    // May be called once.
+    [[nodiscard]] Future<T>
+    get_future()
+    {
+        assert(state_ != nullptr && !retrieved_);
+
+        retrieved_ = true;
+        state_->acquire();
+
+        return Future<T>{state_.get()};
+    }
+
+    template <typename... Args>
+    void
+    set_value(Args&&... args)
+    {
+        state_->setValue(std::forward<Args>(args)...);
+        state_.reset();
+    }
+
+    void
+    set_exception(std::exception_ptr exception) noexcept
+    {
+        state_->setException(std::move(exception));
+        state_.reset();
+    }
+
+    // Sets the result of func(args...), or the exception it throws.
+    template <typename F, typename... Args>
+    void
+    set_with(F& func, Args&&... args) noexcept
+    {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                func(std::forward<Args>(args)...);
+                set_value();
+            }
+            else {
+                set_value(func(std::forward<Args>(args)...));
+            }
+        }
+        catch (...) {
+            set_exception(std::current_exception());
+        }
+    }
+
+private:
+    void
+    abandon() noexcept
+    {
+        if (state_ != nullptr) {
+            set_exception(std::make_exception_ptr(std::future_error{std::future_errc::broken_promise}));
+        }
+    }
+
+    detail::StatePtr<T> state_;
+    bool                retrieved_{false};
+};
+
+// Consumer side, move-only. get() blocks like std::future::get(); then() does not: the continuation is queued on
+// the executor once the result is in. An exception skips the continuations and comes out of the last future.
+template <typename T>
+class Future
+{
+public:
+    Future() noexcept                          = default;
+    Future(Future&& other) noexcept            = default;
+    Future& operator=(Future&& other) noexcept = default;
+    Future(const Future&)                      = delete;
+    Future& operator=(const Future&)           = delete;
+    ~Future()                                  = default;
+
+    [[nodiscard]] bool
+    valid() const noexcept
+    {
+        return state_ != nullptr;
+    }
+
+    [[nodiscard]] bool
+    is_ready() const noexcept
+    {
+        return state_ != nullptr && state_->ready();
+    }
+
+    void
+    wait() const noexcept
+    {
+        state_->wait();
+    }
+
+    // Blocks until the result is in. Leaves the future invalid.
+    T
+    get()
+    {
+        state_->wait();
+
+        const detail::StatePtr<T> state{std::move(state_)};
+
+        if (state->failed()) {
+            std::rethrow_exception(state->exception());
+        }
+
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(state->value());
+        }
+    }
+
+    // func takes the value (nothing for a Future<void>) and runs as a task of the executor. Leaves this future
+    // invalid and returns the future of the result of func.
+    template <typename F>
+    Future<detail::ThenResult<T, F>>
+    then(F&& func)
+    {
+        using Result = detail::ThenResult<T, F>;
+
+        static_assert(!detail::IsFuture<Result>::value, "continuations returning a future are not unwrapped");
+
+        auto* state = state_.release();
+
+        Promise<Result> next{state->executor()};
+        auto            future = next.get_future();
+
+        state->onReady([state, next = std::move(next), func = std::forward<F>(func)]() mutable {
+            state->executor().execute([state, next = std::move(next), func = std::move(func)]() mutable {
+                const detail::StatePtr<T> owned{state};
+
+                if (state->failed()) {
+                    next.set_exception(state->exception());
+                }
+                else if constexpr (std::is_void_v<T>) {
+                    next.set_with(func);
+                }
+                else {
+                    next.set_with(func, std::move(state->value()));
+                }
+            });
+        });
+
+        return future;
+    }
+
+private:
+    friend class Promise<T>;
+    friend struct detail::FutureAccess;
+
+    explicit Future(detail::SharedState<T>* state) noexcept
+      : state_{state}
+    {
+    }
+
+    detail::StatePtr<T> state_;
+};
+
+template <typename T>
+struct WhenAnyResult
+{
+    std::size_t        index;  // of the future that completed first
+    detail::ValueOf<T> value;
+};
+
+namespace detail
+{
+struct FutureAccess
+{
+    template <typename T>
+    static SharedState<T>*
+    release(Future<T>& future) noexcept
+    {
+        assert(future.valid());
+
+        return future.state_.release();
+    }
+};
+
+// State of when_all(): the values collected so far and the number of futures still pending.
+template <typename Result, typename Values>
+struct Collector
+{
+    Collector(ITaskExecutor& executor, const std::size_t count)
+      : promise{executor}
+      , remaining{count}
+    {
+    }
+
+    // Stores the value of state, or fails the promise with its exception. True for the arrival that has to set
+    // the value, i.e. the last one when nothing failed.
+    template <typename T, typename Store>
+    bool
+    arrive(SharedState<T>* state, Store&& store) noexcept
+    {
+        const StatePtr<T> owned{state};
+
+        if (state->failed()) {
+            if (!failed.exchange(true, std::memory_order_acq_rel)) {
+                promise.set_exception(state->exception());
+            }
+        }
+        else {
+            store(std::move(state->value()));
+        }
+
+        return remaining.fetch_sub(1U, std::memory_order_acq_rel) == 1U && !failed.load(std::memory_order_acquire);
+    }
+
+    Promise<Result>          promise;
+    Values                   values{};
+    std::atomic<std::size_t> remaining;
+    std::atomic<bool>        failed{false};
+};
+
+// State of when_any(): the first arrival wins.
+template <typename T>
+struct Race
+{
+    explicit Race(ITaskExecutor& executor)
+      : promise{executor}
+    {
+    }
+
+    Promise<WhenAnyResult<T>> promise;
+    std::atomic<bool>         done{false};
+};
+
+// The states of the combinators come from the task memory as well.
+template <typename State, typename... Args>
+std::shared_ptr<State>
+allocateShared(ITaskExecutor& executor, Args&&... args)
+{
+    return std::allocate_shared<State>(
+        std::pmr::polymorphic_allocator<State>{executor.memory()}, executor, std::forward<Args>(args)...);
+}
+}  // namespace detail
+
+// Completes with all the values once every future has, or with the first exception. A void future contributes a
+// Unit. The futures are consumed; the combined one belongs to the executor of the first.
+template <typename First, typename... Rest>
+Future<std::tuple<detail::ValueOf<First>, detail::ValueOf<Rest>...>>
+when_all(Future<First> first, Future<Rest>... rest)
+{
+    using Result    = std::tuple<detail::ValueOf<First>, detail::ValueOf<Rest>...>;
+    using Values    = std::tuple<std::optional<detail::ValueOf<First>>, std::optional<detail::ValueOf<Rest>>...>;
+    using Collector = detail::Collector<Result, Values>;
+
+    const auto states =
+        std::make_tuple(detail::FutureAccess::release(first), detail::FutureAccess::release(rest)...);
+
+    auto collector = detail::allocateShared<Collector>(std::get<0>(states)->executor(), 1U + sizeof...(Rest));
+    auto future    = collector->promise.get_future();
+
+    const auto unpack = [](Values& values) {
+        return std::apply(
+            [](auto&... value) {
+                return Result{std::move(*value)...};
+            },
+            values);
+    };
+
+    [&states, &collector, &unpack]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (std::get<Is>(states)->onReady([collector, unpack, state = std::get<Is>(states)]() {
+            const auto store = [&collector](auto&& value) {
+                std::get<Is>(collector->values).emplace(std::move(value));
+            };
+
+            if (collector->arrive(state, store)) {
+                collector->promise.set_with(unpack, collector->values);
+            }
+        }),
+         ...);
+    }(std::index_sequence_for<First, Rest...>{});
+
+    return future;
+}
+
+// when_all() for a run-time number of futures of one type; the values come in the order of the futures.
+template <typename T>
+Future<std::vector<detail::ValueOf<T>>>
+when_all(ITaskExecutor& executor, std::vector<Future<T>> futures)
+{
+    using Result    = std::vector<detail::ValueOf<T>>;
+    using Values    = std::vector<std::optional<detail::ValueOf<T>>>;
+    using Collector = detail::Collector<Result, Values>;
+
+    if (futures.empty()) {
+        Promise<Result> promise{executor};
+        auto            future = promise.get_future();
+
+        promise.set_value();
+
+        return future;
+    }
+
+    auto collector = detail::allocateShared<Collector>(executor, futures.size());
+    auto future    = collector->promise.get_future();
+
+    collector->values.resize(futures.size());
+
+    const auto unpack = [](Values& values) {
+        Result result;
+        result.reserve(values.size());
+
+        for (auto& value : values) {
+            result.push_back(std::move(*value));
+        }
+
+        return result;
+    };
+
+    for (std::size_t i{0U}; i < futures.size(); ++i) {
+        auto* state = detail::FutureAccess::release(futures[i]);
+
+        state->onReady([collector, unpack, state, i]() {
+            const auto store = [&collector, i](auto&& value) {
+                collector->values[i].emplace(std::move(value));
+            };
+
+            if (collector->arrive(state, store)) {
+                collector->promise.set_with(unpack, collector->values);
+            }
+        });
+    }
+
+    return future;
+}
+
+// Completes with the index and the result of the first future to complete, be it a value or an exception.
+template <typename T>
+Future<WhenAnyResult<T>>
+when_any(ITaskExecutor& executor, std::vector<Future<T>> futures)
+{
+    using Race = detail::Race<T>;
+
+    auto race   = detail::allocateShared<Race>(executor);
+    auto future = race->promise.get_future();
+
+    if (futures.empty()) {
+        race->promise.set_exception(std::make_exception_ptr(std::invalid_argument{"when_any() of no futures"}));
+
+        return future;
+    }
+
+    for (std::size_t i{0U}; i < futures.size(); ++i) {
+        auto* state = detail::FutureAccess::release(futures[i]);
+
+        state->onReady([race, state, i]() {
+            const detail::StatePtr<T> owned{state};
+
+            if (race->done.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+
+            if (state->failed()) {
+                race->promise.set_exception(state->exception());
+            }
+            else {
+                const auto result = [&state, i]() {
+                    return WhenAnyResult<T>{i, std::move(state->value())};
+                };
+
+                race->promise.set_with(result);
+            }
+        });
+    }
+
+    return future;
+}
+
+}  // namespace executor
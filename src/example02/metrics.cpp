@@ -0,0 +1,148 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace executor
+{
+
+std::size_t
+HistogramSnapshot::bucketOf(const Duration value) noexcept
+{
+    if (value <= Duration::zero()) {
+        return 0U;
+    }
+
+    return std::min<std::size_t>(std::bit_width(static_cast<uint64_t>(value.count())), kBuckets - 1U);
+}
+
+HistogramSnapshot::Duration
+HistogramSnapshot::upperBound(const std::size_t bucket) noexcept
+{
+    if (bucket + 1U >= kBuckets) {
+        return Duration::max();
+    }
+
+    return Duration{int64_t{1} << bucket};
+}
+
+HistogramSnapshot::Duration
+HistogramSnapshot::percentile(const double q) const noexcept
+{
+    if (count == 0U) {
+        return Duration::zero();
+    }
+
+    const double   quantile = std::clamp(q, 0.0, 1.0) * static_cast<double>(count);
+    const uint64_t rank     = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(quantile)), 1U);
+
+    uint64_t seen = 0U;
+
+    for (std::size_t bucket{0U}; bucket < kBuckets; ++bucket) {
+        seen += buckets[bucket];
+
+        if (seen >= rank) {
+            return std::min(upperBound(bucket), max);
+        }
+    }
+
+    return max;
+}
+
+HistogramSnapshot::Duration
+HistogramSnapshot::mean() const noexcept
+{
+    return count != 0U ? sum / static_cast<int64_t>(count) : Duration::zero();
+}
+
+void
+HistogramSnapshot::merge(const HistogramSnapshot& other) noexcept
+{
+    for (std::size_t bucket{0U}; bucket < kBuckets; ++bucket) {
+        buckets[bucket] += other.buckets[bucket];
+    }
+
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+void
+LatencyHistogram::record(const Duration value) noexcept
+{
+    const int64_t nanoseconds = std::max<int64_t>(value.count(), 0);
+
+    buckets_[HistogramSnapshot::bucketOf(value)].fetch_add(1U, std::memory_order_relaxed);
+    sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    int64_t max = max_.load(std::memory_order_relaxed);
+
+    while (nanoseconds > max && !max_.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot
+LatencyHistogram::snapshot() const noexcept
+{
+    HistogramSnapshot result;
+
+    for (std::size_t bucket{0U}; bucket < HistogramSnapshot::kBuckets; ++bucket) {
+        result.buckets[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+        result.count += result.buckets[bucket];
+    }
+
+    result.sum = Duration{sum_.load(std::memory_order_relaxed)};
+    result.max = Duration{max_.load(std::memory_order_relaxed)};
+
+    return result;
+}
+
+void
+ExecutorMetrics::periodicStarted(const Duration deviation) noexcept
+{
+    periodicDeviation_.record(deviation);
+    periodicRuns_.fetch_add(1U, std::memory_order_relaxed);
+}
+
+void
+ExecutorMetrics::periodicFinished(const Duration elapsed, const Duration period) noexcept
+{
+    if (elapsed > period) {
+        periodicOverruns_.fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+
+MetricsSnapshot
+ExecutorMetrics::snapshot() const noexcept
+{
+    MetricsSnapshot result;
+
+    for (const Stripe& stripe : stripes_) {
+        result.queueWait.merge(stripe.queueWait.snapshot());
+        result.runTime.merge(stripe.runTime.snapshot());
+        result.submitted += stripe.submitted.load(std::memory_order_relaxed);
+        result.completed += stripe.completed.load(std::memory_order_relaxed);
+        result.expired   += stripe.expired.load(std::memory_order_relaxed);
+    }
+
+    // a task can be counted as completed on one stripe before its submission shows on another
+    result.inFlight          = result.submitted > result.completed ? result.submitted - result.completed : 0U;
+    result.periodicDeviation = periodicDeviation_.snapshot();
+    result.periodicRuns      = periodicRuns_.load(std::memory_order_relaxed);
+    result.periodicOverruns  = periodicOverruns_.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+ExecutorMetrics::Stripe&
+ExecutorMetrics::stripe() noexcept
+{
+    static std::atomic<std::size_t> nextStripe{0U};
+
+    thread_local const std::size_t index = nextStripe.fetch_add(1U, std::memory_order_relaxed) % kStripes;
+
+    return stripes_[index];
+}
+
+}  // namespace executor
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace executor
+{
+
+// Counts of a LatencyHistogram. Bucket 0 counts zeros, bucket b > 0 the values in [2^(b-1), 2^b) ns and the last
+// bucket everything from 2^(kBuckets-2) ns (about 4.6 minutes) up.
+struct HistogramSnapshot
+{
+    using Duration = std::chrono::nanoseconds;
+
+    static constexpr std::size_t kBuckets = 40U;
+
+    [[nodiscard]] static std::size_t bucketOf(Duration value) noexcept;
+
+    // Exclusive upper bound of bucket; Duration::max() for the last one.
+    [[nodiscard]] static Duration upperBound(std::size_t bucket) noexcept;
+
+    // Upper bound of the bucket holding the q-quantile, 0 <= q <= 1, capped at max; zero when empty.
+    [[nodiscard]] Duration percentile(double q) const noexcept;
+
+    [[nodiscard]] Duration mean() const noexcept;
+
+    void merge(const HistogramSnapshot& other) noexcept;
+
+    std::array<uint64_t, kBuckets> buckets{};
+    uint64_t                       count{0U};
+    Duration                       sum{0};
+    Duration                       max{0};
+};
+
+// Power-of-two latency histogram. record() is a few relaxed atomic adds, with no lock and no allocation;
+// snapshot() can run at the same time and may miss the records still in progress.
+class LatencyHistogram
+{
+public:
+    using Duration = HistogramSnapshot::Duration;
+
+    // Negative values count as zero.
+    void record(Duration value) noexcept;
+
+    [[nodiscard]] HistogramSnapshot snapshot() const noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::kBuckets> buckets_{};
+    std::atomic<int64_t>                                           sum_{0};
+    std::atomic<int64_t>                                           max_{0};
+};
+
+struct MetricsSnapshot
+{
+    HistogramSnapshot queueWait;          // spawned, posted and submitted tasks: from enqueue to start
+    HistogramSnapshot runTime;            // ... and from start to end
+    HistogramSnapshot periodicDeviation;  // periodic runs: start behind the due time
+    uint64_t          submitted{0U};
+    uint64_t          completed{0U};
+    uint64_t          inFlight{0U};  // submitted and not completed, i.e. queued or running
+    uint64_t          expired{0U};   // dropped unrun past their deadline (Options::dropExpired), also completed
+    uint64_t          periodicRuns{0U};
+    uint64_t          periodicOverruns{0U};  // runs that took longer than the period
+};
+
+// Metrics of one Executor (see Options::metrics). The task counters and histograms are striped by thread, so
+// workers recording at the same time do not share cache lines; snapshot() adds the stripes up.
+class ExecutorMetrics final
+{
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration  = Clock::duration;
+
+    static constexpr std::size_t kStripes = 8U;
+
+    ExecutorMetrics() = default;
+
+    ExecutorMetrics(const ExecutorMetrics&)            = delete;
+    ExecutorMetrics& operator=(const ExecutorMetrics&) = delete;
+    ExecutorMetrics(ExecutorMetrics&&)                 = delete;
+    ExecutorMetrics& operator=(ExecutorMetrics&&)      = delete;
+
+    void
+    queued(const uint64_t count = 1U) noexcept
+    {
+        stripe().submitted.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void
+    dropped() noexcept
+    {
+        stripe().expired.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    // Runs func, a task queued at posted; an exception propagates after the task has been counted.
+    template <typename F>
+    void
+    measure(const TimePoint posted, F& func)
+    {
+        Stripe&    stripe = this->stripe();
+        const auto start  = Clock::now();
+
+        stripe.queueWait.record(start - posted);
+
+        const auto finished = [&stripe, start](void*) {
+            stripe.runTime.record(Clock::now() - start);
+            stripe.completed.fetch_add(1U, std::memory_order_relaxed);
+        };
+
+        const std::unique_ptr<void, decltype(finished)> onExit{this, finished};
+
+        func();
+    }
+
+    void periodicStarted(Duration deviation) noexcept;
+
+    void periodicFinished(Duration elapsed, Duration period) noexcept;
+
+    [[nodiscard]] MetricsSnapshot snapshot() const noexcept;
+
+private:
+    struct alignas(64) Stripe
+    {
+        LatencyHistogram      queueWait;
+        LatencyHistogram      runTime;
+        std::atomic<uint64_t> submitted{0U};
+        std::atomic<uint64_t> completed{0U};
+        std::atomic<uint64_t> expired{0U};
+    };
+
+    Stripe& stripe() noexcept;
+
+    std::array<Stripe, kStripes> stripes_;
+    LatencyHistogram             periodicDeviation_;
+    std::atomic<uint64_t>        periodicRuns_{0U};
+    std::atomic<uint64_t>        periodicOverruns_{0U};
+};
+
+}  // namespace executor
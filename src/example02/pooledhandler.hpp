@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+namespace executor
+{
+
+// Completion handler wrapper whose associated allocator is a memory resource, so that asio takes the memory of the
+// operation it queues for the handler from that resource instead of operator new.
+template <typename F>
+class PooledHandler
+{
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    PooledHandler(F func, std::pmr::memory_resource* memory)
+      : func_{std::move(func)}
+      , allocator_{memory}
+    {
+    }
+
+    [[nodiscard]] allocator_type
+    get_allocator() const noexcept
+    {
+        return allocator_;
+    }
+
+    template <typename... Args>
+    void
+    operator()(Args&&... args)
+    {
+        func_(std::forward<Args>(args)...);
+    }
+
+private:
+    F              func_;
+    allocator_type allocator_;
+};
+
+}  // namespace executor
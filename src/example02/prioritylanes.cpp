@@ -0,0 +1,261 @@
+#include "prioritylanes.hpp"
+
+#include "example06/ringbuffer.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace executor
+{
+
+struct PriorityLanes::Lane
+{
+    explicit Lane(const std::size_t capacity)
+      : ring{capacity}
+    {
+    }
+
+    // try_push also fails on a lost race with another producer; only a full ring is final
+    bool
+    pushRing(Task* item)
+    {
+        while (!ring.try_push(item)) {
+            if (ring.size() >= ring.capacity()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void
+    pushOverflow(Task* item)
+    {
+        const std::lock_guard<std::mutex> lock{overflowMutex};
+
+        overflow.push_back(item);
+        hasOverflow.store(true, std::memory_order_release);
+    }
+
+    // behind the overflowed tasks of the lane, if any, so the lane stays FIFO and they are not starved
+    void
+    push(Task* item)
+    {
+        if (hasOverflow.load(std::memory_order_acquire) || !pushRing(item)) {
+            pushOverflow(item);
+        }
+    }
+
+    // Moves overflowed tasks, oldest first, into the ring while it has room; another thread refilling is as good.
+    void
+    refill()
+    {
+        const std::unique_lock<std::mutex> lock{overflowMutex, std::try_to_lock};
+
+        if (!lock.owns_lock()) {
+            return;
+        }
+
+        while (overflowHead < overflow.size() && pushRing(overflow[overflowHead])) {
+            ++overflowHead;
+        }
+
+        // drop the moved prefix once it is at least half of the list: amortized O(1), and nothing is freed
+        if (2U * overflowHead >= overflow.size()) {
+            overflow.erase(overflow.begin(), overflow.begin() + static_cast<std::ptrdiff_t>(overflowHead));
+            overflowHead = 0U;
+        }
+
+        hasOverflow.store(!overflow.empty(), std::memory_order_release);
+    }
+
+    MPMCRingBuffer<Task*> ring;
+    std::mutex            overflowMutex;
+    std::vector<Task*>    overflow;          // behind the ring: while it holds tasks, new ones queue up here too
+    std::size_t           overflowHead{0U};  // overflow is FIFO from here on and keeps its capacity
+    std::atomic<bool>     hasOverflow{false};
+};
+
+PriorityLanes::PriorityLanes(const std::size_t          capacity,
+                             const std::size_t          drainers,
+                             const Weights&             weights,
+                             std::pmr::memory_resource* memory)
+  : allocator_{memory}
+  , weights_{weights}
+  , maxDrainers_{std::max<std::size_t>(drainers, 1U)}
+{
+    for (auto& lane : lanes_) {
+        lane = std::make_unique<Lane>(capacity);
+    }
+
+    for (const auto weight : weights_) {
+        round_ += weight;
+    }
+}
+
+PriorityLanes::~PriorityLanes()
+{
+    for (auto& lane : lanes_) {
+        while (Task* task = popFrom(*lane)) {
+            allocator_.delete_object(task);
+        }
+    }
+}
+
+bool
+PriorityLanes::push(const Priority priority, Task task)
+{
+    lanes_[static_cast<std::size_t>(priority)]->push(allocator_.new_object<Task>(std::move(task)));
+
+    // Pairs with next(): either this sees a drainer that is still going, or that drainer sees this task.
+    queued_.fetch_add(1U);
+
+    return tryStartDrainer();
+}
+
+std::size_t
+PriorityLanes::push(const Priority priority, const std::span<Task> tasks)
+{
+    if (tasks.empty()) {
+        return 0U;
+    }
+
+    Lane& lane = *lanes_[static_cast<std::size_t>(priority)];
+
+    for (std::size_t i{0U}; i < tasks.size(); ++i) {
+        Task* item = allocator_.new_object<Task>(std::move(tasks[i]));
+
+        if (lane.hasOverflow.load(std::memory_order_acquire) || !lane.pushRing(item)) {
+            // the ring is full: the rest of the batch goes behind it under one lock
+            const std::lock_guard<std::mutex> lock{lane.overflowMutex};
+
+            lane.overflow.push_back(item);
+
+            for (++i; i < tasks.size(); ++i) {
+                lane.overflow.push_back(allocator_.new_object<Task>(std::move(tasks[i])));
+            }
+
+            lane.hasOverflow.store(true, std::memory_order_release);
+        }
+    }
+
+    // As in push(): published before the drainers are counted.
+    queued_.fetch_add(tasks.size());
+
+    return startDrainers(tasks.size());
+}
+
+PriorityLanes::Task*
+PriorityLanes::pop()
+{
+    // Take one of the queued tasks first. Its push has completed, so the scan below finds a task, if only after a
+    // concurrent push ahead of it in the same ring has published its slot.
+    std::size_t queued = queued_.load(std::memory_order_relaxed);
+
+    do {
+        if (queued == 0U) {
+            return nullptr;
+        }
+    } while (!queued_.compare_exchange_weak(queued, queued - 1U, std::memory_order_acquire));
+
+    const std::size_t preferred = preferredLane();
+
+    while (true) {
+        if (Task* task = popFrom(*lanes_[preferred])) {
+            return task;
+        }
+
+        for (auto& lane : lanes_) {
+            if (Task* task = popFrom(*lane)) {
+                return task;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+void
+PriorityLanes::finish(Task* task)
+{
+    if (task != nullptr) {
+        allocator_.delete_object(task);
+    }
+}
+
+bool
+PriorityLanes::next()
+{
+    if (queued_.load() > 0U) {
+        return true;
+    }
+
+    drainers_.fetch_sub(1U);
+
+    // A push that found every drainer busy just before the decrement is picked up here.
+    return queued_.load() > 0U && tryStartDrainer();
+}
+
+std::size_t
+PriorityLanes::size() const
+{
+    return queued_.load(std::memory_order_relaxed);
+}
+
+bool
+PriorityLanes::tryStartDrainer()
+{
+    return startDrainers(1U) == 1U;
+}
+
+std::size_t
+PriorityLanes::startDrainers(const std::size_t wanted)
+{
+    std::size_t drainers = drainers_.load();
+
+    while (drainers < maxDrainers_) {
+        const std::size_t started = std::min(wanted, maxDrainers_ - drainers);
+
+        if (drainers_.compare_exchange_weak(drainers, drainers + started)) {
+            return started;
+        }
+    }
+
+    return 0U;
+}
+
+std::size_t
+PriorityLanes::preferredLane()
+{
+    if (round_ == 0U) {
+        return 0U;  // no weights: strict priority
+    }
+
+    uint64_t turn = turn_.fetch_add(1U, std::memory_order_relaxed) % round_;
+
+    for (std::size_t i{0U}; i < kPrioritiesCount; ++i) {
+        if (turn < weights_[i]) {
+            return i;
+        }
+
+        turn -= weights_[i];
+    }
+
+    return 0U;
+}
+
+PriorityLanes::Task*
+PriorityLanes::popFrom(Lane& lane)
+{
+    if (lane.hasOverflow.load(std::memory_order_acquire)) {
+        lane.refill();
+    }
+
+    Task* task = nullptr;
+
+    return lane.ring.try_pop(task) ? task : nullptr;
+}
+
+}  // namespace executor
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "smallfunction.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+
+template <typename T>
+class MPMCRingBuffer;
+
+namespace executor
+{
+
+// Per-priority task queues in front of an executor backend. Tasks wait in the lane of their priority, and a
+// bounded number of drainers, each a task of the backend, run them one per turn: so a flood of tasks occupies at
+// most `drainers` entries of the backend's own queue and a timer handler queued behind them waits for that many
+// tasks, not for the whole flood. Every turn takes from the lane the weighted round-robin designates, or from the
+// highest non-empty lane when that one is empty: higher lanes go first, and with weights {16, 4, 1} a busy
+// background lane still gets one turn in 21. Tasks live in memory taken from the given resource.
+class PriorityLanes final
+{
+public:
+    using Task = SmallFunction<void()>;
+
+    enum class Priority
+    {
+        kCritical,
+        kNormal,
+        kBackground,
+    };
+
+    static constexpr std::size_t kPrioritiesCount = 3U;
+
+    using Weights = std::array<uint32_t, kPrioritiesCount>;
+
+    PriorityLanes(std::size_t                capacity,
+                  std::size_t                drainers,
+                  const Weights&             weights,
+                  std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    ~PriorityLanes();
+
+    PriorityLanes(const PriorityLanes&)            = delete;
+    PriorityLanes& operator=(const PriorityLanes&) = delete;
+    PriorityLanes(PriorityLanes&&)                 = delete;
+    PriorityLanes& operator=(PriorityLanes&&)      = delete;
+
+    // True when the caller has to start a drainer for it.
+    [[nodiscard]] bool push(Priority priority, Task task);
+
+    // All of tasks into one lane, with one update of the queued count; returns how many drainers the caller has
+    // to start.
+    [[nodiscard]] std::size_t push(Priority priority, std::span<Task> tasks);
+
+    // The next task by priority and weight, or nullptr when the lanes are empty. Give it back with finish().
+    [[nodiscard]] Task* pop();
+
+    void finish(Task* task);
+
+    // Called by a drainer after its turn: true when it has to go on with another one, false when it has retired.
+    [[nodiscard]] bool next();
+
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    struct Lane;
+
+    bool tryStartDrainer();
+
+    // Reserves up to wanted more drainers; returns how many it got.
+    std::size_t startDrainers(std::size_t wanted);
+
+    [[nodiscard]] std::size_t preferredLane();
+
+    Task* popFrom(Lane& lane);
+
+    std::pmr::polymorphic_allocator<Task>               allocator_;
+    std::array<std::unique_ptr<Lane>, kPrioritiesCount> lanes_;
+    Weights                                             weights_;
+    uint64_t                                            round_{0U};  // sum of the weights
+    std::size_t                                         maxDrainers_;
+    std::atomic<std::size_t>                            queued_{0U};  // pushed and not yet taken by pop()
+    std::atomic<std::size_t>                            drainers_{0U};
+    std::atomic<uint64_t>                               turn_{0U};
+};
+
+}  // namespace executor
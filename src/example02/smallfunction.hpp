@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace executor
+{
+
+template <typename Signature, std::size_t Capacity = 64>
+class SmallFunction;
+
+// Move-only type-erased callable, like std::move_only_function, that stores callables of up to Capacity bytes
+// inline. Only larger (or throwing-move) callables go to the heap, so the task lambdas of the executor are
+// constructed, moved between queues and destroyed without an allocation.
+template <typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+public:
+    SmallFunction() noexcept = default;
+
+    SmallFunction(std::nullptr_t) noexcept  // NOLINT(google-explicit-constructor)
+    {
+    }
+
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, SmallFunction>
+                 && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    SmallFunction(F&& func)  // NOLINT(google-explicit-constructor)
+    {
+        using Callable = std::decay_t<F>;
+
+        if constexpr (kStoredInline<Callable>) {
+            ::new (static_cast<void*>(buffer_)) Callable(std::forward<F>(func));
+            vtable_ = &kInlineVTable<Callable>;
+        }
+        else {
+            ::new (static_cast<void*>(buffer_)) Callable*(new Callable(std::forward<F>(func)));
+            vtable_ = &kHeapVTable<Callable>;
+        }
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept
+      : vtable_{other.vtable_}
+    {
+        if (vtable_ != nullptr) {
+            vtable_->move(buffer_, other.buffer_);
+            other.vtable_ = nullptr;
+        }
+    }
+
+    SmallFunction&
+    operator=(SmallFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+
+            if (other.vtable_ != nullptr) {
+                other.vtable_->move(buffer_, other.buffer_);
+                vtable_       = other.vtable_;
+                other.vtable_ = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    SmallFunction(const SmallFunction&)            = delete;
+    SmallFunction& operator=(const SmallFunction&) = delete;
+
+    ~SmallFunction()
+    {
+        reset();
+    }
+
+    explicit
+    operator bool() const noexcept
+    {
+        return vtable_ != nullptr;
+    }
+
+    R
+    operator()(Args... args)
+    {
+        return vtable_->invoke(buffer_, std::forward<Args>(args)...);
+    }
+
+    // True when a callable of type F is stored without a heap allocation.
+    template <typename F>
+    static constexpr bool kStoredInline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t)
+                                       && std::is_nothrow_move_constructible_v<F>;
+
+private:
+    struct VTable
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* destination, void* source) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename F>
+    static constexpr VTable kInlineVTable{
+        [](void* storage, Args&&... args) -> R {
+            return std::invoke(*std::launder(static_cast<F*>(storage)), std::forward<Args>(args)...);
+        },
+        [](void* destination, void* source) noexcept {
+            auto* from = std::launder(static_cast<F*>(source));
+
+            ::new (destination) F(std::move(*from));
+            from->~F();
+        },
+        [](void* storage) noexcept {
+            std::launder(static_cast<F*>(storage))->~F();
+        },
+    };
+
+    template <typename F>
+    static constexpr VTable kHeapVTable{
+        [](void* storage, Args&&... args) -> R {
+            return std::invoke(**std::launder(static_cast<F**>(storage)), std::forward<Args>(args)...);
+        },
+        [](void* destination, void* source) noexcept {
+            ::new (destination) F*(*std::launder(static_cast<F**>(source)));
+        },
+        [](void* storage) noexcept {
+            delete *std::launder(static_cast<F**>(storage));
+        },
+    };
+
+    void
+    reset() noexcept
+    {
+        if (vtable_ != nullptr) {
+            vtable_->destroy(buffer_);
+            vtable_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) std::byte buffer_[Capacity];
+    const VTable* vtable_{nullptr};
+};
+
+}  // namespace executor
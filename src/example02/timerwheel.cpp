@@ -0,0 +1,271 @@
+#include "timerwheel.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace executor
+{
+
+TimerWheel::TimerWheel(asio::io_context& ioContext, const Duration tick)
+  : strand_{asio::make_strand(ioContext)}
+  , timer_{strand_}
+  , tick_{std::max(tick, Duration{1})}
+  , origin_{Clock::now()}
+{
+    for (auto& level : levels_) {
+        for (auto& head : level) {
+            head.prev = &head;
+            head.next = &head;
+        }
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    for (auto& level : levels_) {
+        for (auto& head : level) {
+            while (head.next != &head) {
+                auto& timer = static_cast<Timer&>(*head.next);
+
+                unlink(timer);
+                timer.callback_(timer.context_, false);
+            }
+        }
+    }
+}
+
+void
+TimerWheel::schedule(Timer& timer, const Duration delay)
+{
+    // An idle wheel does not advance: catch up first, or the wakeup would lie in the past and advance() would step
+    // through every tick since.
+    if (size_ == 0U) {
+        current_ = std::max(current_, ticksUntil(Clock::now(), false));
+    }
+
+    if (timer.scheduled()) {
+        unlink(timer);
+    }
+    else {
+        ++size_;
+    }
+
+    timer.expiry_ = std::max(current_, ticksUntil(Clock::now() + delay, true));
+
+    place(timer);
+
+    if (!armed_ || timer.expiry_ < armedTick_) {
+        arm();
+    }
+}
+
+void
+TimerWheel::cancel(Timer& timer)
+{
+    if (!timer.scheduled()) {
+        return;
+    }
+
+    unlink(timer);
+
+    // Nothing left: drop the wakeup so the io_context can run out of work.
+    if (--size_ == 0U && armed_) {
+        armed_ = false;
+        timer_.cancel();
+    }
+}
+
+TimerWheel::TimePoint
+TimerWheel::expiry(const Timer& timer) const
+{
+    return origin_ + tick_ * static_cast<Duration::rep>(timer.expiry_);
+}
+
+TimerWheel::Duration
+TimerWheel::tick() const
+{
+    return tick_;
+}
+
+std::size_t
+TimerWheel::size() const
+{
+    return size_;
+}
+
+const TimerWheel::Strand&
+TimerWheel::executor() const
+{
+    return strand_;
+}
+
+void
+TimerWheel::push(Link& head, Link& link)
+{
+    link.prev       = head.prev;
+    link.next       = &head;
+    head.prev->next = &link;
+    head.prev       = &link;
+}
+
+void
+TimerWheel::unlink(Link& link)
+{
+    link.prev->next = link.next;
+    link.next->prev = link.prev;
+    link.prev       = nullptr;
+    link.next       = nullptr;
+}
+
+void
+TimerWheel::splice(Link& from, Link& to)
+{
+    if (from.next == &from) {
+        return;
+    }
+
+    from.next->prev = to.prev;
+    to.prev->next   = from.next;
+    from.prev->next = &to;
+    to.prev         = from.prev;
+    from.prev       = &from;
+    from.next       = &from;
+}
+
+void
+TimerWheel::place(Timer& timer)
+{
+    // Beyond the range of the wheel: park in the last level at its far end, cascading brings it back.
+    const uint64_t delta  = std::min(timer.expiry_ - current_, kRange - 1U);
+    const uint64_t expiry = current_ + delta;
+
+    std::size_t level{0U};
+
+    while (level + 1U < kLevels && delta >= (1ULL << (kSlotBits * (level + 1U)))) {
+        ++level;
+    }
+
+    push(levels_[level][(expiry >> (kSlotBits * level)) & kSlotMask], timer);
+}
+
+void
+TimerWheel::cascade(const std::size_t level, const uint64_t tick)
+{
+    Link pending;
+    pending.prev = &pending;
+    pending.next = &pending;
+
+    splice(levels_[level][(tick >> (kSlotBits * level)) & kSlotMask], pending);
+
+    while (pending.next != &pending) {
+        auto& timer = static_cast<Timer&>(*pending.next);
+
+        unlink(timer);
+        place(timer);
+    }
+}
+
+void
+TimerWheel::advance(const TimePoint now)
+{
+    const uint64_t target = ticksUntil(now, false);
+
+    if (size_ == 0U) {
+        current_ = std::max(current_, target + 1U);
+        return;
+    }
+
+    Link expired;
+    expired.prev = &expired;
+    expired.next = &expired;
+
+    // A throwing callback leaves the rest of the slot to the next tick. On the way out the wakeup is armed again.
+    const auto requeue = [this, &expired](void*) {
+        splice(expired, levels_[0][current_ & kSlotMask]);
+        arm();
+    };
+
+    const std::unique_ptr<void, decltype(requeue)> onExit{this, requeue};
+
+    while (current_ <= target && size_ > 0U) {
+        // Higher levels first: a timer coming down from level 2 may land in the level-1 slot cascaded next.
+        for (std::size_t level = kLevels - 1U; level > 0U; --level) {
+            if ((current_ & ((1ULL << (kSlotBits * level)) - 1U)) == 0U) {
+                cascade(level, current_);
+            }
+        }
+
+        splice(levels_[0][current_ & kSlotMask], expired);
+
+        // Move on before the callbacks run, so a timer they re-arm lands in a later slot.
+        ++current_;
+
+        while (expired.next != &expired) {
+            auto& timer = static_cast<Timer&>(*expired.next);
+
+            unlink(timer);
+            --size_;
+            timer.callback_(timer.context_, true);
+        }
+    }
+
+    current_ = std::max(current_, target + 1U);
+}
+
+void
+TimerWheel::arm()
+{
+    if (size_ == 0U) {
+        return;
+    }
+
+    // The next occupied level-0 slot, or the next cascade, whichever comes first.
+    uint64_t wakeup = current_;
+
+    for (uint64_t i{0U}; i < kSlots; ++i, ++wakeup) {
+        const bool occupied = levels_[0][wakeup & kSlotMask].next != &levels_[0][wakeup & kSlotMask];
+
+        if (occupied || (i > 0U && (wakeup & kSlotMask) == 0U)) {
+            break;
+        }
+    }
+
+    if (armed_ && armedTick_ <= wakeup) {
+        return;
+    }
+
+    armed_     = true;
+    armedTick_ = wakeup;
+
+    timer_.expires_at(origin_ + tick_ * static_cast<Duration::rep>(wakeup));
+    timer_.async_wait([this](const asio::error_code& errorCode) {
+        onTimer(errorCode);
+    });
+}
+
+void
+TimerWheel::onTimer(const asio::error_code& errorCode)
+{
+    if (errorCode == asio::error::operation_aborted) {
+        return;
+    }
+
+    armed_ = false;
+
+    advance(Clock::now());
+}
+
+uint64_t
+TimerWheel::ticksUntil(const TimePoint timePoint, const bool roundUp) const
+{
+    if (timePoint <= origin_) {
+        return 0U;
+    }
+
+    const auto elapsed = (timePoint - origin_).count();
+    const auto tick    = tick_.count();
+
+    return static_cast<uint64_t>(roundUp ? (elapsed + tick - 1) / tick : elapsed / tick);
+}
+
+}  // namespace executor
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace executor
+{
+
+// Hierarchical timing wheel (Varghese and Lauck): four levels of 64 slots, so timers up to 64^4 ticks ahead are
+// placed in O(1) and later ones are parked in the last level until they come into range. Timers are intrusive
+// nodes owned by the caller; schedule(), re-arming and cancel() only relink them, nothing is allocated. One
+// steady_timer per wheel wakes up at the next occupied tick and expires the whole slot in one go.
+//
+// Everything runs on a strand of the io_context: schedule() and cancel() must be called from it (see executor()),
+// which the timer callbacks already are.
+class TimerWheel final
+{
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using Duration  = Clock::duration;
+    using Strand    = asio::strand<asio::io_context::executor_type>;
+
+private:
+    struct Link
+    {
+        Link* prev{nullptr};
+        Link* next{nullptr};
+    };
+
+public:
+    class Timer : private Link
+    {
+    public:
+        // fired is false when the wheel is destroyed with the timer still scheduled.
+        using Callback = void (*)(void* context, bool fired);
+
+        Timer(Callback callback, void* context)
+          : callback_{callback}
+          , context_{context}
+        {
+        }
+
+        Timer(const Timer&)            = delete;
+        Timer& operator=(const Timer&) = delete;
+        Timer(Timer&&)                 = delete;
+        Timer& operator=(Timer&&)      = delete;
+
+        // Must be cancelled first; the wheel does not own its timers.
+        ~Timer()
+        {
+            assert(!scheduled());
+        }
+
+        [[nodiscard]] bool
+        scheduled() const noexcept
+        {
+            return next != nullptr;
+        }
+
+    private:
+        friend class TimerWheel;
+
+        uint64_t expiry_{0U};  // in ticks since the wheel was created
+        Callback callback_{nullptr};
+        void*    context_{nullptr};
+    };
+
+    TimerWheel(asio::io_context& ioContext, Duration tick);
+
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&)            = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&)                 = delete;
+    TimerWheel& operator=(TimerWheel&&)      = delete;
+
+    // (Re)arms timer to fire delay from now, rounded up to the next tick.
+    void schedule(Timer& timer, Duration delay);
+
+    void cancel(Timer& timer);
+
+    // The tick the timer was last scheduled for, as a time point.
+    [[nodiscard]] TimePoint expiry(const Timer& timer) const;
+
+    [[nodiscard]] Duration tick() const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] const Strand& executor() const;
+
+private:
+    static constexpr std::size_t kLevels   = 4U;
+    static constexpr uint64_t    kSlotBits = 6U;
+    static constexpr uint64_t    kSlots    = 1U << kSlotBits;
+    static constexpr uint64_t    kSlotMask = kSlots - 1U;
+    static constexpr uint64_t    kRange    = 1ULL << (kSlotBits * kLevels);
+
+    using Level = std::array<Link, kSlots>;  // circular lists, the heads point to themselves when empty
+
+    static void push(Link& head, Link& link);
+
+    static void unlink(Link& link);
+
+    static void splice(Link& from, Link& to);
+
+    void place(Timer& timer);
+
+    void cascade(std::size_t level, uint64_t tick);
+
+    void advance(TimePoint now);
+
+    void arm();
+
+    void onTimer(const asio::error_code& errorCode);
+
+    [[nodiscard]] uint64_t ticksUntil(TimePoint timePoint, bool roundUp) const;
+
+    Strand                     strand_;
+    asio::steady_timer         timer_;
+    Duration                   tick_;
+    TimePoint                  origin_;
+    uint64_t                   current_{0U};  // next tick to expire
+    uint64_t                   armedTick_{0U};
+    bool                       armed_{false};
+    std::size_t                size_{0U};
+    std::array<Level, kLevels> levels_;
+};
+
+}  // namespace executor
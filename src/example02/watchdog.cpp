@@ -1,6 +1,7 @@
 #include "watchdog.hpp"
 
 #include <algorithm>
+#include <memory>
 
 namespace executor
 {
@@ -68,18 +69,43 @@ IntervalWatchdog::deactivate()
     tock_.store(now);
 }
 
-WatchdogManager::WatchdogManager() = default;
+WatchdogManager::WatchdogManager(const std::size_t slotsCount)
+  : slotsCount_{std::min<std::size_t>(slotsCount, kNoSlot / 2U)}  // the upper half is for the overflow list
+  , slots_{std::make_unique<IntervalSlot[]>(slotsCount_)}
+  , next_{std::make_unique<std::atomic<Slot>[]>(slotsCount_)}
+{
+}
 
 WatchdogManager::~WatchdogManager() = default;
 
 bool
 WatchdogManager::check()
 {
+    const auto timePoint = IWatchdog::Clock::now();
+    const auto now       = timePoint.time_since_epoch().count();
+
+    bool result = true;
+
+    const std::size_t used = used_.load(std::memory_order_acquire);
+
+    for (std::size_t i{0U}; i < used && result; ++i) {
+        const auto start = slots_[i].start.load(std::memory_order_acquire);
+
+        // A slot released and claimed again while it is read is judged on a mix of both intervals; harmless.
+        if (start != kIdle && now - start > slots_[i].limit.load(std::memory_order_relaxed)) {
+            result = false;
+        }
+    }
+
     const std::lock_guard<std::mutex> lockGuard(mutex_);
 
-    return std::ranges::all_of(watchdogs_, [timePoint = IWatchdog::Clock::now()](const auto& watchdog) -> bool {
-        return watchdog->check(timePoint);
-    });
+    result = result && std::ranges::all_of(overflow_, [now](const OverflowInterval& interval) -> bool {
+                 return interval.start == kIdle || now - interval.start <= interval.limit;
+             });
+
+    return result && std::ranges::all_of(watchdogs_, [timePoint](const auto& watchdog) -> bool {
+               return watchdog->check(timePoint);
+           });
 }
 
 void
@@ -100,4 +126,136 @@ WatchdogManager::unregisterWatchdog(const std::shared_ptr<IWatchdog>& watchdog)
     std::erase(watchdogs_, watchdog);
 }
 
+WatchdogManager::Slot
+WatchdogManager::startInterval(const IWatchdog::Duration duration)
+{
+    const std::size_t own  = threadFreeList();
+    Slot              slot = pop(freeLists_[own]);
+
+    // Recycled slots first, the ones freed on other threads included; untouched slots only when there are none.
+    for (std::size_t i{1U}; slot == kNoSlot && i < kFreeListsCount; ++i) {
+        slot = pop(freeLists_[(own + i) % kFreeListsCount]);
+    }
+
+    if (slot == kNoSlot) {
+        std::size_t used = used_.load(std::memory_order_relaxed);
+
+        while (used < slotsCount_ && !used_.compare_exchange_weak(used, used + 1U, std::memory_order_acq_rel)) {
+        }
+
+        if (used >= slotsCount_) {
+            return startOverflow(duration);
+        }
+
+        slot = static_cast<Slot>(used);
+    }
+
+    slots_[slot].limit.store(duration.count(), std::memory_order_relaxed);
+    slots_[slot].start.store(IWatchdog::Clock::now().time_since_epoch().count(), std::memory_order_release);
+
+    return slot;
+}
+
+void
+WatchdogManager::finishInterval(const Slot slot)
+{
+    if (slot == kNoSlot) {
+        return;
+    }
+
+    if (slot >= slotsCount_) {
+        finishOverflow(slot);
+        return;
+    }
+
+    slots_[slot].start.store(kIdle, std::memory_order_release);
+
+    push(freeLists_[threadFreeList()], slot);
+}
+
+std::size_t
+WatchdogManager::overflowed() const
+{
+    return overflowed_.load(std::memory_order_relaxed);
+}
+
+WatchdogManager::Slot
+WatchdogManager::startOverflow(const IWatchdog::Duration duration)
+{
+    overflowed_.fetch_add(1U, std::memory_order_relaxed);
+
+    const std::lock_guard<std::mutex> lockGuard(mutex_);
+
+    Slot index = 0U;
+
+    if (!overflowFree_.empty()) {
+        index = overflowFree_.back();
+        overflowFree_.pop_back();
+    }
+    else if (overflow_.size() < kNoSlot - slotsCount_) {
+        index = static_cast<Slot>(overflow_.size());
+        overflow_.emplace_back();
+    }
+    else {
+        return kNoSlot;
+    }
+
+    overflow_[index] = OverflowInterval{IWatchdog::Clock::now().time_since_epoch().count(), duration.count()};
+
+    return static_cast<Slot>(slotsCount_ + index);
+}
+
+void
+WatchdogManager::finishOverflow(const Slot slot)
+{
+    const auto index = static_cast<Slot>(slot - slotsCount_);
+
+    const std::lock_guard<std::mutex> lockGuard(mutex_);
+
+    overflow_[index].start = kIdle;
+    overflowFree_.push_back(index);
+}
+
+WatchdogManager::Slot
+WatchdogManager::pop(FreeList& list)
+{
+    uint64_t head = list.head.load(std::memory_order_acquire);
+
+    while (true) {
+        const auto slot = static_cast<Slot>(head);
+
+        if (slot == kNoSlot) {
+            return kNoSlot;
+        }
+
+        // next_ may be stale when another thread took the slot meanwhile; the tag makes the exchange fail then.
+        const uint64_t next = (((head >> 32U) + 1U) << 32U) | next_[slot].load(std::memory_order_relaxed);
+
+        if (list.head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+}
+
+void
+WatchdogManager::push(FreeList& list, const Slot slot)
+{
+    uint64_t head = list.head.load(std::memory_order_relaxed);
+
+    do {
+        next_[slot].store(static_cast<Slot>(head), std::memory_order_relaxed);
+    } while (!list.head.compare_exchange_weak(
+        head, (((head >> 32U) + 1U) << 32U) | slot, std::memory_order_release, std::memory_order_relaxed));
+}
+
+std::size_t
+WatchdogManager::threadFreeList()
+{
+    static std::atomic<std::size_t> threads{0U};
+
+    thread_local const std::size_t index = threads.fetch_add(1U, std::memory_order_relaxed) % kFreeListsCount;
+
+    return index;
+}
+
 }  // namespace executor
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -79,10 +83,21 @@ private:
     std::atomic<TimeSinceEpoch> tock_;
 };
 
+// Watches two kinds of watchdogs. Long-lived ones (a PeriodicTask's) are registered as objects under a mutex.
+// The short intervals of spawned and posted tasks go through startInterval()/finishInterval() instead: a
+// preallocated table of slots, claimed and released in O(1) without locks through free lists sharded by thread,
+// and scanned by check() without blocking either side. Intervals started while every slot is taken are still
+// watched, through a list under the mutex; overflowed() counts them, to size the table by.
 class WatchdogManager final
 {
 public:
-    explicit WatchdogManager();
+    using Slot = uint32_t;
+
+    static constexpr Slot        kNoSlot         = UINT32_MAX;
+    static constexpr std::size_t kDefaultSlots   = 16384U;
+    static constexpr std::size_t kFreeListsCount = 16U;
+
+    explicit WatchdogManager(std::size_t slotsCount = kDefaultSlots);
 
     ~WatchdogManager();
 
@@ -97,9 +112,59 @@ public:
 
     void unregisterWatchdog(const std::shared_ptr<IWatchdog>& watchdog);
 
+    // Starts watching an interval that must finish within duration. When every slot is taken the interval goes to
+    // the overflow list, and the slot returned is slotsCount or above.
+    [[nodiscard]] Slot startInterval(IWatchdog::Duration duration);
+
+    // Accepts kNoSlot.
+    void finishInterval(Slot slot);
+
+    // Intervals that found every slot taken, since construction.
+    [[nodiscard]] std::size_t overflowed() const;
+
 private:
+    struct IntervalSlot
+    {
+        std::atomic<IWatchdog::TimeSinceEpoch> start{kIdle};
+        std::atomic<IWatchdog::Duration::rep>  limit{0};
+    };
+
+    // Treiber stack of slot indices; the upper half of head is a tag against ABA.
+    struct alignas(64) FreeList
+    {
+        std::atomic<uint64_t> head{kNoSlot};
+    };
+
+    // An interval on the overflow list, guarded by mutex_.
+    struct OverflowInterval
+    {
+        IWatchdog::TimeSinceEpoch start{kIdle};
+        IWatchdog::Duration::rep  limit{0};
+    };
+
+    static constexpr IWatchdog::TimeSinceEpoch kIdle = std::numeric_limits<IWatchdog::TimeSinceEpoch>::min();
+
+    Slot startOverflow(IWatchdog::Duration duration);
+
+    void finishOverflow(Slot slot);
+
+    Slot pop(FreeList& list);
+
+    void push(FreeList& list, Slot slot);
+
+    static std::size_t threadFreeList();
+
     std::mutex                              mutex_;
     std::vector<std::shared_ptr<IWatchdog>> watchdogs_;
+    std::vector<OverflowInterval>           overflow_;      // slot slotsCount_ + i
+    std::vector<Slot>                       overflowFree_;  // free entries of overflow_
+
+    const std::size_t                     slotsCount_;
+    std::unique_ptr<IntervalSlot[]>       slots_;
+    std::unique_ptr<std::atomic<Slot>[]>  next_;  // free list links
+    std::array<FreeList, kFreeListsCount> freeLists_;
+    alignas(64) std::atomic<std::size_t>  used_{0U};  // slots below this have been handed out at least once
+    std::atomic<std::size_t>              overflowed_{0U};
 };
 
 }  // namespace executor
@@ -0,0 +1,204 @@
+#include "workerthread.hpp"
+
+#include <sched.h>
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+namespace executor
+{
+
+namespace
+{
+constexpr std::size_t kMaxThreadNameLength = 15U;  // without the terminating zero
+
+// Name and CPU set of the calling thread before anything was applied to it, put back for whatever a later config
+// leaves empty. A WorkerThread records them as soon as it starts.
+struct ThreadDefaults
+{
+    std::array<char, kMaxThreadNameLength + 1U> name{};
+    cpu_set_t                                   cpus{};
+    bool                                        hasCpus{false};
+};
+
+const ThreadDefaults&
+threadDefaults()
+{
+    thread_local const ThreadDefaults defaults = []() {
+        ThreadDefaults result;
+
+        pthread_getname_np(pthread_self(), result.name.data(), result.name.size());
+
+        CPU_ZERO(&result.cpus);
+        result.hasCpus = pthread_getaffinity_np(pthread_self(), sizeof(result.cpus), &result.cpus) == 0;
+
+        return result;
+    }();
+
+    return defaults;
+}
+}  // namespace
+
+void
+applyThreadConfig(const ThreadConfig& config)
+{
+    const pthread_t       self     = pthread_self();
+    const ThreadDefaults& defaults = threadDefaults();
+
+    // A reused thread may still carry the name and CPU set of an earlier run: empty fields restore the defaults.
+    const std::string name = config.name.empty() ? std::string{defaults.name.data()}
+                                                 : config.name.substr(0U, kMaxThreadNameLength);
+
+    if (const int error = pthread_setname_np(self, name.c_str()); error != 0) {
+        spdlog::warn("Executor: cannot name thread {}: {}", name, std::strerror(error));
+    }
+
+    if (!config.cpus.empty()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+
+        for (const int cpu : config.cpus) {
+            CPU_SET(static_cast<std::size_t>(cpu), &cpus);
+        }
+
+        if (const int error = pthread_setaffinity_np(self, sizeof(cpus), &cpus); error != 0) {
+            spdlog::warn("Executor: cannot pin thread {} to its CPU set: {}", config.name, std::strerror(error));
+        }
+    }
+    else if (defaults.hasCpus) {
+        if (const int error = pthread_setaffinity_np(self, sizeof(defaults.cpus), &defaults.cpus); error != 0) {
+            spdlog::warn("Executor: cannot unpin thread {}: {}", name, std::strerror(error));
+        }
+    }
+
+    if (config.fifoPriority > 0) {
+        sched_param param{};
+        param.sched_priority = config.fifoPriority;
+
+        if (const int error = pthread_setschedparam(self, SCHED_FIFO, &param); error != 0) {
+            spdlog::warn("Executor: SCHED_FIFO refused for thread {} ({}), keeping SCHED_OTHER",
+                         config.name,
+                         std::strerror(error));
+        }
+    }
+    else {
+        // A reused thread may still carry the real-time policy of an earlier run.
+        int         policy{0};
+        sched_param param{};
+
+        if (pthread_getschedparam(self, &policy, &param) == 0 && policy != SCHED_OTHER) {
+            param.sched_priority = 0;
+            pthread_setschedparam(self, SCHED_OTHER, &param);
+        }
+    }
+}
+
+WorkerThread::WorkerThread(const std::size_t stackSize)
+  : stackSize_{stackSize}
+{
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+
+    const auto destroyAttributes = [&attributes](void*) {
+        pthread_attr_destroy(&attributes);
+    };
+
+    const std::unique_ptr<void, decltype(destroyAttributes)> onExit{this, destroyAttributes};
+
+    if (stackSize_ != 0U) {
+        if (const int error = pthread_attr_setstacksize(&attributes, stackSize_); error != 0) {
+            throw std::system_error{error, std::generic_category(), "WorkerThread: invalid stack size"};
+        }
+    }
+
+    if (const int error = pthread_create(&handle_, &attributes, &WorkerThread::entry, this); error != 0) {
+        throw std::system_error{error, std::generic_category(), "WorkerThread: cannot create thread"};
+    }
+}
+
+WorkerThread::~WorkerThread()
+{
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+
+        condition_.wait(lock, [this]() {
+            return !busy_;
+        });
+
+        exit_ = true;
+    }
+
+    condition_.notify_all();
+
+    pthread_join(handle_, nullptr);
+}
+
+void
+WorkerThread::start(Job job)
+{
+    {
+        const std::lock_guard<std::mutex> lock{mutex_};
+
+        job_  = std::move(job);
+        busy_ = true;
+    }
+
+    condition_.notify_all();
+}
+
+void
+WorkerThread::wait()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    condition_.wait(lock, [this]() {
+        return !busy_;
+    });
+}
+
+std::size_t
+WorkerThread::stackSize() const
+{
+    return stackSize_;
+}
+
+void*
+WorkerThread::entry(void* self)
+{
+    static_cast<WorkerThread*>(self)->loop();
+
+    return nullptr;
+}
+
+void
+WorkerThread::loop()
+{
+    static_cast<void>(threadDefaults());  // before the first job changes anything
+
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (true) {
+        condition_.wait(lock, [this]() {
+            return busy_ || exit_;
+        });
+
+        if (!busy_) {
+            return;
+        }
+
+        Job job = std::move(job_);
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        busy_ = false;
+        condition_.notify_all();
+    }
+}
+
+}  // namespace executor
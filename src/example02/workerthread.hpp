@@ -0,0 +1,65 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace executor
+{
+
+struct ThreadConfig
+{
+    std::string      name;             // pthread name, cut to 15 characters; empty: the one the thread started with
+    std::vector<int> cpus;             // CPU set the thread is pinned to; empty: the one the thread started with
+    int              fifoPriority{0};  // > 0 asks for SCHED_FIFO, falls back to SCHED_OTHER when not permitted
+};
+
+// Applies config to the calling thread. Failures to pin or rename are logged and ignored, like a refused
+// SCHED_FIFO: placement is a tuning knob and never a reason not to run.
+void applyThreadConfig(const ThreadConfig& config);
+
+// A pthread that runs one job after the other, so an Executor keeps its threads (and their stacks, names and
+// placement) across stop()/restart() instead of creating new ones on every run().
+class WorkerThread final
+{
+public:
+    using Job = std::function<void()>;
+
+    // stackSize 0 keeps the default; throws std::system_error when the thread cannot be created.
+    explicit WorkerThread(std::size_t stackSize = 0U);
+
+    // Waits for the current job, then joins.
+    ~WorkerThread();
+
+    WorkerThread(const WorkerThread&)            = delete;
+    WorkerThread& operator=(const WorkerThread&) = delete;
+    WorkerThread(WorkerThread&&)                 = delete;
+    WorkerThread& operator=(WorkerThread&&)      = delete;
+
+    // Hands a job to the thread; the previous one must have finished (see wait()).
+    void start(Job job);
+
+    void wait();
+
+    [[nodiscard]] std::size_t stackSize() const;
+
+private:
+    static void* entry(void* self);
+
+    void loop();
+
+    std::size_t             stackSize_;
+    pthread_t               handle_{};
+    std::mutex              mutex_;
+    std::condition_variable condition_;
+    Job                     job_;
+    bool                    busy_{false};
+    bool                    exit_{false};
+};
+
+}  // namespace executor
@@ -0,0 +1,306 @@
+#include "workstealingscheduler.hpp"
+
+#include "example06/ringbuffer.hpp"
+
+#include <thread>
+
+namespace executor
+{
+
+namespace
+{
+constexpr size_t kSpinRounds = 64U;
+}  // namespace
+
+struct WorkStealingScheduler::Worker
+{
+    Worker(WorkStealingScheduler* scheduler, const uint64_t seed)
+      : owner{scheduler}
+      , random{seed | 1U}
+    {
+    }
+
+    // xorshift64, only used to pick steal victims
+    size_t
+    nextVictim(const size_t count)
+    {
+        random ^= random << 13U;
+        random ^= random >> 7U;
+        random ^= random << 17U;
+
+        return random % count;
+    }
+
+    WorkStealingScheduler* owner;
+    ChaseLevDeque<Task*>   deque;
+    uint64_t               random;
+};
+
+thread_local WorkStealingScheduler::Worker* WorkStealingScheduler::current_{nullptr};
+
+WorkStealingScheduler::WorkStealingScheduler(asio::io_context&          ioContext,
+                                             const size_t               injectionCapacity,
+                                             std::pmr::memory_resource* memory)
+  : ioContext_{ioContext}
+  , allocator_{memory}
+  , injection_{std::make_unique<MPMCRingBuffer<Task*>>(injectionCapacity)}
+{
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+    Task* task = nullptr;
+
+    for (auto& worker : workers_) {
+        while (worker->deque.pop(task)) {
+            allocator_.delete_object(task);
+        }
+    }
+
+    while (injection_->try_pop(task)) {
+        allocator_.delete_object(task);
+    }
+
+    for (size_t i{overflowHead_}; i < overflow_.size(); ++i) {
+        allocator_.delete_object(overflow_[i]);
+    }
+}
+
+void
+WorkStealingScheduler::post(Task task)
+{
+    Task* item = allocator_.new_object<Task>(std::move(task));
+
+    ioContext_.get_executor().on_work_started();
+
+    if (current_ != nullptr && current_->owner == this) {
+        current_->deque.push(item);
+    }
+    else if (hasOverflow_.load(std::memory_order_acquire) || !inject(item)) {
+        const std::lock_guard<std::mutex> lock{overflowMutex_};
+
+        overflow_.push_back(item);
+        hasOverflow_.store(true, std::memory_order_release);
+    }
+
+    notify();
+}
+
+void
+WorkStealingScheduler::postBatch(const std::span<Task> tasks)
+{
+    if (tasks.empty()) {
+        return;
+    }
+
+    const bool local = current_ != nullptr && current_->owner == this;
+
+    for (size_t i{0U}; i < tasks.size(); ++i) {
+        Task* item = allocator_.new_object<Task>(std::move(tasks[i]));
+
+        ioContext_.get_executor().on_work_started();
+
+        if (local) {
+            current_->deque.push(item);
+        }
+        else if (hasOverflow_.load(std::memory_order_acquire) || !inject(item)) {
+            const std::lock_guard<std::mutex> lock{overflowMutex_};
+
+            overflow_.push_back(item);
+
+            for (++i; i < tasks.size(); ++i) {
+                overflow_.push_back(allocator_.new_object<Task>(std::move(tasks[i])));
+                ioContext_.get_executor().on_work_started();
+            }
+
+            hasOverflow_.store(true, std::memory_order_release);
+        }
+    }
+
+    notify(tasks.size());
+}
+
+void
+WorkStealingScheduler::prepare(const size_t workersCount)
+{
+    while (workers_.size() < workersCount) {
+        workers_.push_back(std::make_unique<Worker>(this, 0x9E37'79B9'7F4A'7C15ULL * (workers_.size() + 1)));
+    }
+
+    stopped_.store(false);
+}
+
+void
+WorkStealingScheduler::run(const size_t index)
+{
+    Worker& self = *workers_.at(index);
+
+    current_ = &self;
+
+    const auto leave = [](void*) {
+        current_ = nullptr;
+    };
+
+    const std::unique_ptr<void, decltype(leave)> onExit{this, leave};
+
+    while (!stopped_.load(std::memory_order_acquire)) {
+        Task* task = nullptr;
+
+        if (findTask(self, task)) {
+            execute(task);
+        }
+        else {
+            park();
+        }
+    }
+}
+
+void
+WorkStealingScheduler::stop()
+{
+    stopped_.store(true);
+    wakeups_.fetch_add(1U);
+    wakeups_.notify_all();
+}
+
+bool
+WorkStealingScheduler::findTask(Worker& self, Task*& task)
+{
+    if (self.deque.pop(task)) {
+        return true;
+    }
+
+    if (hasOverflow_.load(std::memory_order_acquire)) {
+        refill();
+    }
+
+    if (injection_->try_pop(task)) {
+        return true;
+    }
+
+    const size_t count = workers_.size();
+    const size_t first = self.nextVictim(count);
+
+    for (size_t i{0U}; i < count; ++i) {
+        Worker& victim = *workers_[(first + i) % count];
+
+        if (&victim != &self && victim.deque.steal(task)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+WorkStealingScheduler::refill()
+{
+    // another worker refilling is as good
+    const std::unique_lock<std::mutex> lock{overflowMutex_, std::try_to_lock};
+
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    while (overflowHead_ < overflow_.size() && inject(overflow_[overflowHead_])) {
+        ++overflowHead_;
+    }
+
+    // Drop the moved prefix once it is at least half of the list: amortized O(1), and nothing is freed.
+    if (2U * overflowHead_ >= overflow_.size()) {
+        overflow_.erase(overflow_.begin(), overflow_.begin() + static_cast<std::ptrdiff_t>(overflowHead_));
+        overflowHead_ = 0U;
+    }
+
+    hasOverflow_.store(!overflow_.empty(), std::memory_order_release);
+}
+
+bool
+WorkStealingScheduler::hasWork() const
+{
+    if (!injection_->empty() || hasOverflow_.load()) {
+        return true;
+    }
+
+    for (const auto& worker : workers_) {
+        if (!worker->deque.empty()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+WorkStealingScheduler::park()
+{
+    for (size_t i{0U}; i < kSpinRounds; ++i) {
+        if (hasWork() || stopped_.load()) {
+            return;
+        }
+
+        std::this_thread::yield();
+    }
+
+    // Announce the sleep before the last look, so a concurrent post() either is seen here or sees the sleeper.
+    sleepers_.fetch_add(1U);
+
+    const auto wakeups = wakeups_.load();
+
+    if (!hasWork() && !stopped_.load()) {
+        wakeups_.wait(wakeups);
+    }
+
+    sleepers_.fetch_sub(1U);
+}
+
+bool
+WorkStealingScheduler::inject(Task* item)
+{
+    // try_push also fails on a lost race with another producer; only a full queue is final
+    while (!injection_->try_push(item)) {
+        if (injection_->size() >= injection_->capacity()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+WorkStealingScheduler::notify(const size_t count)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint32_t sleepers = sleepers_.load();
+
+    if (sleepers == 0U) {
+        return;
+    }
+
+    wakeups_.fetch_add(1U);
+
+    if (count >= sleepers) {
+        wakeups_.notify_all();
+    }
+    else {
+        for (size_t i{0U}; i < count; ++i) {
+            wakeups_.notify_one();
+        }
+    }
+}
+
+void
+WorkStealingScheduler::execute(Task* task)
+{
+    const auto finished = [this, task](void*) {
+        allocator_.delete_object(task);
+        ioContext_.get_executor().on_work_finished();
+    };
+
+    const std::unique_ptr<void, decltype(finished)> onExit{this, finished};
+
+    (*task)();
+}
+
+}  // namespace executor
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "chaselevdeque.hpp"
+#include "smallfunction.hpp"
+
+#include <asio/io_context.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+template <typename T>
+class MPMCRingBuffer;
+
+namespace executor
+{
+
+// Task scheduler behind Executor::Backend::kWorkStealing. Every worker owns a Chase-Lev deque: tasks posted from a
+// worker go to its own deque, tasks posted from any other thread go through a bounded lock-free injection queue
+// (with a locked FIFO overflow list behind it), and an idle worker steals from a randomly chosen victim before it
+// parks. While the overflow list holds tasks, new ones queue up behind them and workers move them back into the
+// injection queue as it drains, so the order is kept and no overflowed task is starved by a steady flow. Each
+// queued task counts as outstanding work of the io_context, so io_context::run() on the reactor thread returns
+// exactly when both the timers and the task queues have run dry. Tasks live in memory taken from the given
+// resource, typically a pool, so posting a small task does not allocate.
+class WorkStealingScheduler final
+{
+public:
+    using Task = SmallFunction<void()>;
+
+    WorkStealingScheduler(asio::io_context&          ioContext,
+                          std::size_t                injectionCapacity,
+                          std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&)            = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler(WorkStealingScheduler&&)                 = delete;
+    WorkStealingScheduler& operator=(WorkStealingScheduler&&)      = delete;
+
+    void post(Task task);
+
+    // Posts every task of tasks (moved out) with one fence and one wakeup round that wakes at most tasks.size()
+    // parked workers; what does not fit the injection queue goes to the overflow list under a single lock.
+    void postBatch(std::span<Task> tasks);
+
+    // Makes sure workers 0..workersCount-1 exist and clears the stop flag; call before starting the workers.
+    void prepare(size_t workersCount);
+
+    // Worker loop of worker `index`; returns after stop(). A task's exception propagates out of it.
+    void run(size_t index);
+
+    void stop();
+
+private:
+    struct Worker;
+
+    bool findTask(Worker& self, Task*& task);
+
+    // Moves overflowed tasks, oldest first, into the injection queue while it has room.
+    void refill();
+
+    bool hasWork() const;
+
+    void park();
+
+    // Queues item without the overflow list; false when the injection queue is full.
+    bool inject(Task* item);
+
+    void notify(std::size_t count = 1U);
+
+    void execute(Task* task);
+
+    asio::io_context&                      ioContext_;
+    std::pmr::polymorphic_allocator<Task>  allocator_;
+    std::vector<std::unique_ptr<Worker>>   workers_;
+    std::unique_ptr<MPMCRingBuffer<Task*>> injection_;
+
+    std::mutex         overflowMutex_;
+    std::vector<Task*> overflow_;  // FIFO from overflowHead_ on; keeps its capacity, so overflowing does not allocate
+    size_t             overflowHead_{0U};
+    std::atomic<bool>  hasOverflow_{false};
+
+    std::atomic<bool>     stopped_{false};
+    std::atomic<uint32_t> sleepers_{0};
+    std::atomic<uint32_t> wakeups_{0};
+
+    static thread_local Worker* current_;
+};
+
+}  // namespace executor
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+// Monotonic scratch allocator for data that all dies at the same point, e.g. the temporaries of one event batch.
+// Allocation bumps a pointer through fixed-size blocks taken from the upstream resource; deallocation is a no-op.
+// reset() rewinds to the first block in O(1) and keeps every block for the next epoch, so a warmed-up arena never
+// goes upstream again. Requests larger than a block get a block of their own, which reset() hands back.
+//
+// The upstream can be any memory resource, including the pools: a SlabMemoryResource serves blocks of up to
+// SlabAllocator::kMaxBlockSize from its size classes. Not thread-safe; give every thread its own arena.
+class Arena
+{
+public:
+    static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit Arena(const std::size_t          blockSize = kDefaultBlockSize,
+                   std::pmr::memory_resource* upstream  = std::pmr::new_delete_resource())
+      : blockSize_{std::max(blockSize, sizeof(Block) + alignof(std::max_align_t))}
+      , upstream_{upstream}
+    {
+    }
+
+    ~Arena()
+    {
+        release();
+    }
+
+    Arena(const Arena&)            = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    [[nodiscard]] void*
+    allocate(const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t))
+    {
+        assert(std::has_single_bit(alignment));
+
+        auto* p = align_up(cursor_, alignment);
+
+        if (p != nullptr && p <= end_ && bytes <= static_cast<std::size_t>(end_ - p)) {
+            cursor_ = p + bytes;
+            return p;
+        }
+
+        return allocate_slow(bytes, alignment);
+    }
+
+    // Starts a new epoch: everything allocated so far is dead. Blocks are kept, oversized ones are returned.
+    void
+    reset() noexcept
+    {
+        release_large();
+
+        current_ = head_;
+        enter(current_);
+        ++epoch_;
+    }
+
+    // Returns every block to the upstream resource.
+    void
+    release() noexcept
+    {
+        release_large();
+
+        for (Block* block = head_; block != nullptr;) {
+            Block* next = block->next;
+            upstream_->deallocate(block, block->size, block->alignment);
+            block = next;
+        }
+
+        head_    = nullptr;
+        current_ = nullptr;
+        enter(nullptr);
+        ++epoch_;
+    }
+
+    // Incremented by every reset() and release(); lets callers assert that scratch data is not kept across epochs.
+    [[nodiscard]] uint64_t
+    epoch() const noexcept
+    {
+        return epoch_;
+    }
+
+    [[nodiscard]] std::size_t
+    block_size() const noexcept
+    {
+        return blockSize_;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource*
+    upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+private:
+    struct Block
+    {
+        Block*      next;
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    static std::byte*
+    align_up(std::byte* p, const std::size_t alignment) noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(p);
+
+        return p + (((address + alignment - 1) & ~(alignment - 1)) - address);
+    }
+
+    static std::byte*
+    data_of(Block* block) noexcept
+    {
+        return reinterpret_cast<std::byte*>(block) + sizeof(Block);
+    }
+
+    void
+    enter(Block* block) noexcept
+    {
+        cursor_ = block != nullptr ? data_of(block) : nullptr;
+        end_    = block != nullptr ? reinterpret_cast<std::byte*>(block) + block->size : nullptr;
+    }
+
+    Block*
+    allocate_block(const std::size_t size, const std::size_t alignment)
+    {
+        auto* block = static_cast<Block*>(upstream_->allocate(size, alignment));
+
+        return ::new (block) Block{nullptr, size, alignment};
+    }
+
+    void*
+    allocate_slow(const std::size_t bytes, const std::size_t alignment)
+    {
+        const auto blockAlignment = std::max(alignment, alignof(std::max_align_t));
+
+        // Too big for a regular block even when it starts empty: give it a block of its own.
+        if (sizeof(Block) + bytes + alignment > blockSize_) {
+            Block* block = allocate_block(sizeof(Block) + bytes + blockAlignment, blockAlignment);
+            block->next  = large_;
+            large_       = block;
+
+            return align_up(data_of(block), alignment);
+        }
+
+        // Move on to the next block kept from an earlier epoch, or append a fresh one.
+        if (current_ != nullptr && current_->next != nullptr) {
+            current_ = current_->next;
+        }
+        else {
+            Block* block = allocate_block(blockSize_, alignof(std::max_align_t));
+
+            if (current_ != nullptr) {
+                current_->next = block;
+            }
+            else {
+                head_ = block;
+            }
+
+            current_ = block;
+        }
+
+        enter(current_);
+
+        auto* p = align_up(cursor_, alignment);
+        cursor_ = p + bytes;
+
+        return p;
+    }
+
+    void
+    release_large() noexcept
+    {
+        for (Block* block = large_; block != nullptr;) {
+            Block* next = block->next;
+            upstream_->deallocate(block, block->size, block->alignment);
+            block = next;
+        }
+
+        large_ = nullptr;
+    }
+
+    const std::size_t          blockSize_;
+    std::pmr::memory_resource* upstream_;
+
+    Block*     head_{nullptr};     // first regular block, the others follow through next
+    Block*     current_{nullptr};  // block the cursor is in
+    Block*     large_{nullptr};    // oversized blocks of the current epoch
+    std::byte* cursor_{nullptr};
+    std::byte* end_{nullptr};
+    uint64_t   epoch_{0};
+};
+
+// std::pmr adapter: containers built on it allocate from the arena and free nothing until reset().
+class ArenaMemoryResource final : public std::pmr::memory_resource
+{
+public:
+    explicit ArenaMemoryResource(const std::size_t          blockSize = Arena::kDefaultBlockSize,
+                                 std::pmr::memory_resource* upstream  = std::pmr::new_delete_resource())
+      : arena_{blockSize, upstream}
+    {
+    }
+
+    ArenaMemoryResource(const ArenaMemoryResource&)            = delete;
+    ArenaMemoryResource& operator=(const ArenaMemoryResource&) = delete;
+
+    // Every container using this resource must be gone (or never touched again) before reset().
+    void
+    reset() noexcept
+    {
+        arena_.reset();
+    }
+
+    [[nodiscard]] Arena&
+    arena() noexcept
+    {
+        return arena_;
+    }
+
+private:
+    void*
+    do_allocate(const std::size_t bytes, const std::size_t alignment) override
+    {
+        return arena_.allocate(bytes, alignment);
+    }
+
+    void
+    do_deallocate(void* /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override
+    {
+    }
+
+    [[nodiscard]] bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    Arena arena_;
+};
+
+// Resets an arena when the scope ends, e.g. around one processEvents() cycle.
+template <typename A>
+class ArenaScope
+{
+public:
+    explicit ArenaScope(A& arena) noexcept
+      : arena_{arena}
+    {
+    }
+
+    ~ArenaScope()
+    {
+        arena_.reset();
+    }
+
+    ArenaScope(const ArenaScope&)            = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    A& arena_;
+};
+
+// The calling thread's own arena resource, created on first use with the default block size.
+inline ArenaMemoryResource&
+threadArena()
+{
+    thread_local ArenaMemoryResource arena;
+
+    return arena;
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include "poolptr.hpp"
+#include "poolstats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Single-threaded pool that tracks free slots in a bitmap (bit set = slot free) instead of an intrusive free list.
+// acquire() always hands out the lowest free slot, so live objects stay packed at the front of the storage, and
+// the slots themselves are never written by the pool. Full words are skipped four at a time with AVX2 when it is
+// enabled; the free bit inside a word is found with countr_zero (tzcnt).
+template <typename T, std::size_t N, typename Stats = NoPoolStats>
+class BitmapBufferPool
+{
+    static_assert(N > 0, "N must be greater than 0");
+
+    static constexpr std::size_t kWordBits = 64;
+    static constexpr std::size_t kWords    = (N + kWordBits - 1) / kWordBits;
+
+public:
+    BitmapBufferPool()
+    {
+        bitmap_.fill(~uint64_t{0});
+        bitmap_.back() = valid_mask(kWords - 1);
+    }
+
+    ~BitmapBufferPool()
+    {
+        if constexpr (Stats::kEnabled) {
+            stats_.report_leaks(leaked_slots());
+        }
+    }
+
+    BitmapBufferPool(const BitmapBufferPool&)            = delete;
+    BitmapBufferPool& operator=(const BitmapBufferPool&) = delete;
+
+    T*
+    acquire()
+    {
+        const auto word = first_free_word(cursor_);
+
+        cursor_ = word;
+
+        if (word == kWords) {
+            stats_.on_exhausted(N);
+            return nullptr;
+        }
+
+        const auto bit = static_cast<std::size_t>(std::countr_zero(bitmap_[word]));
+
+        bitmap_[word] &= bitmap_[word] - 1;
+        ++inUse_;
+        stats_.on_acquire(N);
+
+        return slot_ptr((word * kWordBits) + bit);
+    }
+
+    void
+    release(T* p)
+    {
+        const auto idx = index_of(p);
+
+        free_slot(idx);
+        cursor_ = std::min(cursor_, idx / kWordBits);
+    }
+
+    // Fills out with the lowest free slots in a single sweep over the bitmap and returns how many it got; fewer
+    // than out.size() only when the pool runs dry.
+    std::size_t
+    acquire_n(std::span<T*> out)
+    {
+        std::size_t count = 0;
+        std::size_t word  = first_free_word(cursor_);
+
+        while (count < out.size() && word < kWords) {
+            uint64_t bits = bitmap_[word];
+
+            for (; bits != 0 && count < out.size(); ++count) {
+                out[count] = slot_ptr((word * kWordBits) + static_cast<std::size_t>(std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+
+            bitmap_[word] = bits;
+
+            if (bits == 0) {
+                word = first_free_word(word + 1);
+            }
+        }
+
+        cursor_ = word;
+        inUse_ += count;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            stats_.on_acquire(N);
+        }
+
+        if (count < out.size()) {
+            stats_.on_exhausted(N);
+        }
+
+        return count;
+    }
+
+    void
+    release_n(std::span<T* const> ptrs)
+    {
+        std::size_t lowest = kWords;
+
+        for (T* p : ptrs) {
+            const auto idx = index_of(p);
+
+            free_slot(idx);
+            lowest = std::min(lowest, idx / kWordBits);
+        }
+
+        cursor_ = std::min(cursor_, lowest);
+    }
+
+    // Calls func(T&) for every acquired slot in address order. The pool does not know whether a T was constructed
+    // in a slot, so this is meant for pools whose slots are filled right after acquire (e.g. through make()).
+    template <typename F>
+    void
+    for_each_live(F&& func)
+    {
+        for (std::size_t word = 0; word < kWords; ++word) {
+            for (uint64_t bits = ~bitmap_[word] & valid_mask(word); bits != 0; bits &= bits - 1) {
+                func(*slot_ptr((word * kWordBits) + static_cast<std::size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+    // Acquires a slot and constructs T in it; the handle destroys and releases it. Empty when exhausted.
+    template <typename... Args>
+    [[nodiscard]] PoolPtr<T, BitmapBufferPool>
+    make(Args&&... args)
+    {
+        return detail::makePooled<T>(*this, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] std::size_t
+    in_use() const noexcept
+    {
+        return inUse_;
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    capacity() noexcept
+    {
+        return N;
+    }
+
+    [[nodiscard]] bool
+    owns(const T* p) const noexcept
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(p);
+
+        return bytes >= memory_.data() && bytes < memory_.data() + memory_.size();
+    }
+
+    [[nodiscard]] const Stats&
+    stats() const noexcept
+    {
+        return stats_;
+    }
+
+    [[nodiscard]] Stats&
+    stats() noexcept
+    {
+        return stats_;
+    }
+
+private:
+    static constexpr uint64_t
+    valid_mask(const std::size_t word) noexcept
+    {
+        const auto bits = std::min(kWordBits, N - (word * kWordBits));
+
+        return bits == kWordBits ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    }
+
+    // First word at or after `from` with a free slot, kWords if there is none.
+    std::size_t
+    first_free_word(std::size_t from) const noexcept
+    {
+#if defined(__AVX2__)
+        for (; from + 4 <= kWords; from += 4) {
+            const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitmap_.data() + from));
+
+            if (_mm256_testz_si256(words, words) == 0) {
+                break;
+            }
+        }
+#endif
+        while (from < kWords && bitmap_[from] == 0) {
+            ++from;
+        }
+
+        return from;
+    }
+
+    void
+    free_slot(const std::size_t idx)
+    {
+        const uint64_t bit = uint64_t{1} << (idx % kWordBits);
+
+        assert((bitmap_[idx / kWordBits] & bit) == 0 && "slot released twice");
+
+        bitmap_[idx / kWordBits] |= bit;
+        --inUse_;
+        stats_.on_release();
+    }
+
+    // Acquired slots; only meaningful once no other thread uses the pool.
+    std::vector<std::size_t>
+    leaked_slots() const
+    {
+        std::vector<std::size_t> leaked;
+
+        for (std::size_t word = 0; word < kWords; ++word) {
+            for (uint64_t bits = ~bitmap_[word] & valid_mask(word); bits != 0; bits &= bits - 1) {
+                leaked.push_back((word * kWordBits) + static_cast<std::size_t>(std::countr_zero(bits)));
+            }
+        }
+
+        return leaked;
+    }
+
+    T*
+    slot_ptr(const std::size_t idx)
+    {
+        return reinterpret_cast<T*>(memory_.data() + (sizeof(T) * idx));
+    }
+
+    std::size_t
+    index_of(const T* p) const
+    {
+        assert(owns(p));
+
+        const auto offset = static_cast<std::size_t>(reinterpret_cast<const uint8_t*>(p) - memory_.data());
+        assert(offset % sizeof(T) == 0);
+
+        return offset / sizeof(T);
+    }
+
+    // No free-list links live in the slots, so they are packed at sizeof(T) and never touched by the pool.
+    alignas(T) std::array<uint8_t, N * sizeof(T)> memory_;
+
+    alignas(32) std::array<uint64_t, kWords> bitmap_;
+
+    std::size_t cursor_{0};  // no free slot below this word
+    std::size_t inUse_{0};
+
+    [[no_unique_address]] Stats stats_;
+};
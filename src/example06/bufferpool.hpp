@@ -1,22 +1,53 @@
 #pragma once
 
+#include "poolptr.hpp"
+#include "poolstats.hpp"
+
 #include <array>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <utility>
+#include <vector>
+
+// kEager threads every slot onto the free list in the constructor. kLazy leaves the storage untouched and hands
+// out never-used slots from a bump index once the free list of recycled slots is empty, so a pool sized for peak
+// load only commits the pages it actually uses.
+enum class PoolInit
+{
+    kEager,
+    kLazy,
+};
 
-template <typename T, std::size_t N>
+// Stats is a statistics policy, see poolstats.hpp; the default NoPoolStats costs nothing.
+template <typename T, std::size_t N, typename Stats = NoPoolStats>
 class BufferPool
 {
     static_assert(N > 0, "N must be greater than 0");
 
 public:
     BufferPool()
+      : BufferPool{PoolInit::kEager}
     {
-        for (std::size_t i = 0; i < N; ++i) {
-            release(reinterpret_cast<T*>(memory_.data() + (kElementSize * i)));
+    }
+
+    explicit BufferPool(const PoolInit init)
+    {
+        if (init == PoolInit::kEager) {
+            for (std::size_t i = 0; i < N; ++i) {
+                push(memory_.data() + (kElementSize * i));
+            }
+
+            bump_ = N;
+        }
+    }
+
+    ~BufferPool()
+    {
+        if constexpr (Stats::kEnabled) {
+            stats_.report_leaks(leaked_slots());
         }
     }
 
@@ -28,17 +59,54 @@ public:
     {
         if (void* free = head_) {
             head_ = *reinterpret_cast<void**>(free);
+            stats_.on_acquire(N);
             return reinterpret_cast<T*>(free);
 
             // std::memcpy(reinterpret_cast<void*>(&head_), free, sizeof(head_));
             // return reinterpret_cast<T*>(free);
         }
 
+        // Recycled slots first: they are already warm, a fresh slot may touch a new page.
+        if (bump_ < N) {
+            stats_.on_acquire(N);
+            return reinterpret_cast<T*>(memory_.data() + (kElementSize * bump_++));
+        }
+
+        stats_.on_exhausted(N);
+
         return nullptr;
     }
 
     void
     release(T* p)
+    {
+        stats_.on_release();
+        push(p);
+    }
+
+    // Acquires a slot and constructs T in it; the handle destroys and releases it. Empty when exhausted.
+    template <typename... Args>
+    [[nodiscard]] PoolPtr<T, BufferPool>
+    make(Args&&... args)
+    {
+        return detail::makePooled<T>(*this, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] const Stats&
+    stats() const noexcept
+    {
+        return stats_;
+    }
+
+    [[nodiscard]] Stats&
+    stats() noexcept
+    {
+        return stats_;
+    }
+
+private:
+    void
+    push(void* p)
     {
         *reinterpret_cast<void**>(p) = head_;
         head_                        = p;
@@ -46,15 +114,39 @@ public:
         // head_ = memcpy(reinterpret_cast<void*>(p), reinterpret_cast<void*>(&head_), sizeof(head_));
     }
 
-private:
+    // Slots not on the free list; only meaningful once no other thread uses the pool.
+    std::vector<std::size_t>
+    leaked_slots() const
+    {
+        std::vector<bool> free(N, false);
+
+        for (void* p = head_; p != nullptr; p = *reinterpret_cast<void**>(p)) {
+            free[static_cast<std::size_t>(static_cast<uint8_t*>(p) - memory_.data()) / kElementSize] = true;
+        }
+
+        std::vector<std::size_t> leaked;
+
+        for (std::size_t i = 0; i < bump_; ++i) {
+            if (!free[i]) {
+                leaked.push_back(i);
+            }
+        }
+
+        return leaked;
+    }
+
     static constexpr std::size_t kElementSize = std::max(sizeof(T), sizeof(void*));
 
-    alignas(std::max(alignof(T), alignof(void*))) std::array<uint8_t, N * kElementSize> memory_{};
+    // Deliberately not value-initialized: zeroing would touch every page up front.
+    alignas(std::max(alignof(T), alignof(void*))) std::array<uint8_t, N * kElementSize> memory_;
 
-    void* head_{nullptr};
+    void*       head_{nullptr};
+    std::size_t bump_{0};  // slots at and above bump_ have never been handed out
+
+    [[no_unique_address]] Stats stats_;
 };
 
-template <typename T, std::size_t N>
+template <typename T, std::size_t N, typename Stats = NoPoolStats>
 class LockFreeBufferPool
 {
     static_assert(N > 0, "N must be greater than 0");
@@ -75,25 +167,144 @@ class LockFreeBufferPool
 
 public:
     LockFreeBufferPool()
+      : LockFreeBufferPool{PoolInit::kEager}
+    {
+    }
+
+    // See PoolInit. In lazy mode a slot's generation is initialized when the bump index first hands it out.
+    explicit LockFreeBufferPool(const PoolInit init)
     {
+        if (init == PoolInit::kLazy) {
+            head_.store(TaggedIndex{kNull, 0}, std::memory_order_relaxed);
+            return;
+        }
+
         for (std::size_t i = 0; i < N; ++i) {
             next_of(static_cast<uint32_t>(i)) = (i + 1 < N) ? static_cast<uint32_t>(i + 1) : kNull;
         }
 
+        generations_.fill(0);
         head_.store(TaggedIndex{0, 0}, std::memory_order_relaxed);
+        bump_.store(static_cast<uint32_t>(N), std::memory_order_relaxed);
+    }
+
+    ~LockFreeBufferPool()
+    {
+        if constexpr (Stats::kEnabled) {
+            stats_.report_leaks(leaked_slots());
+        }
     }
 
     LockFreeBufferPool(const LockFreeBufferPool&)            = delete;
     LockFreeBufferPool& operator=(const LockFreeBufferPool&) = delete;
 
+    // Slot index plus the slot's generation at acquire time. The generation is bumped on every release, so a
+    // handle that outlived its object no longer resolves. Eight bytes, cheap to pass through the ring buffers.
+    struct Handle
+    {
+        uint32_t index{kNull};
+        uint32_t generation{0};
+
+        explicit
+        operator bool() const noexcept
+        {
+            return index != kNull;
+        }
+
+        friend bool operator==(const Handle&, const Handle&) = default;
+    };
+
+    static_assert(sizeof(Handle) == sizeof(uint64_t));
+
     T*
     acquire()
+    {
+        const auto idx = pop_index();
+
+        return idx != kNull ? slot_ptr(idx) : nullptr;
+    }
+
+    void
+    release(T* p)
+    {
+        push_index(index_of(p));
+    }
+
+    // Empty handle when exhausted.
+    [[nodiscard]] Handle
+    acquire_handle()
+    {
+        const auto idx = pop_index();
+
+        if (idx == kNull) {
+            return Handle{};
+        }
+
+        return Handle{idx, generation_of(idx).load(std::memory_order_relaxed)};
+    }
+
+    // nullptr when the handle is empty or stale. Only detects handles whose slot was already released; it does not
+    // keep the object alive against a concurrent release.
+    [[nodiscard]] T*
+    resolve(const Handle handle)
+    {
+        if (handle.index >= bump_.load(std::memory_order_acquire)
+            || generation_of(handle.index).load(std::memory_order_acquire) != handle.generation) {
+            return nullptr;
+        }
+
+        return slot_ptr(handle.index);
+    }
+
+    void
+    release(const Handle handle)
+    {
+        assert(resolve(handle) != nullptr && "stale or empty handle");
+
+        push_index(handle.index);
+    }
+
+    // Acquires a slot and constructs T in it; the handle destroys and releases it. Empty when exhausted.
+    template <typename... Args>
+    [[nodiscard]] PoolPtr<T, LockFreeBufferPool>
+    make(Args&&... args)
+    {
+        return detail::makePooled<T>(*this, std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] const Stats&
+    stats() const noexcept
+    {
+        return stats_;
+    }
+
+    [[nodiscard]] Stats&
+    stats() noexcept
+    {
+        return stats_;
+    }
+
+private:
+    uint32_t
+    pop_index()
     {
         TaggedIndex old_head = head_.load(std::memory_order_acquire);
+        uint32_t    retries  = 0;
 
         while (true) {
             if (old_head.index == kNull) {
-                return nullptr;
+                const auto idx = bump_index();
+
+                stats_.on_cas_retries(retries);
+
+                if (idx == kNull) {
+                    stats_.on_exhausted(N);
+                }
+                else {
+                    stats_.on_acquire(N);
+                }
+
+                return idx;
             }
 
             TaggedIndex new_head;
@@ -101,17 +312,38 @@ public:
             new_head.tag   = old_head.tag + 1;
 
             if (head_.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire)) {
-                return slot_ptr(old_head.index);
+                stats_.on_cas_retries(retries);
+                stats_.on_acquire(N);
+                return old_head.index;
+            }
+
+            ++retries;
+        }
+    }
+
+    // Claims the next never-used slot; kNull once all N have been handed out at least once.
+    uint32_t
+    bump_index()
+    {
+        uint32_t bump = bump_.load(std::memory_order_relaxed);
+
+        while (bump < N) {
+            if (bump_.compare_exchange_weak(bump, bump + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                generation_of(bump).store(0, std::memory_order_release);
+                return bump;
             }
         }
+
+        return kNull;
     }
 
     void
-    release(T* p)
+    push_index(const uint32_t idx)
     {
-        const auto idx = index_of(p);
+        generation_of(idx).fetch_add(1, std::memory_order_release);
 
         TaggedIndex old_head = head_.load(std::memory_order_acquire);
+        uint32_t    retries  = 0;
 
         while (true) {
             next_of(idx) = old_head.index;
@@ -121,12 +353,43 @@ public:
             new_head.tag   = old_head.tag + 1;
 
             if (head_.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                stats_.on_cas_retries(retries);
+                stats_.on_release();
                 return;
             }
+
+            ++retries;
         }
     }
 
-private:
+    // Slots not on the free list; only meaningful once no other thread uses the pool.
+    std::vector<std::size_t>
+    leaked_slots()
+    {
+        std::vector<bool> free(N, false);
+
+        for (auto idx = head_.load(std::memory_order_acquire).index; idx != kNull; idx = next_of(idx)) {
+            free[idx] = true;
+        }
+
+        std::vector<std::size_t> leaked;
+        const auto               bump = bump_.load(std::memory_order_acquire);
+
+        for (std::size_t i = 0; i < bump; ++i) {
+            if (!free[i]) {
+                leaked.push_back(i);
+            }
+        }
+
+        return leaked;
+    }
+
+    std::atomic_ref<uint32_t>
+    generation_of(uint32_t idx)
+    {
+        return std::atomic_ref<uint32_t>{generations_[idx]};
+    }
+
     T*
     slot_ptr(uint32_t idx)
     {
@@ -151,8 +414,17 @@ private:
         return idx;
     }
 
-    alignas(kElementAlign) std::array<uint8_t, N * kElementSize> memory_{};
+    // Neither array is value-initialized, so a lazy pool touches no page before its slots are used.
+    alignas(kElementAlign) std::array<uint8_t, N * kElementSize> memory_;
+
+    // Kept apart from the slots so a live object's bytes are never touched by the pool.
+    std::array<uint32_t, N> generations_;
 
     static constexpr std::size_t kCacheLineSize = 64;
     alignas(kCacheLineSize) std::atomic<TaggedIndex> head_;
+
+    // Only written until every slot has been handed out once, so it gets its own line instead of sharing head_'s.
+    alignas(kCacheLineSize) std::atomic<uint32_t> bump_{0};
+
+    [[no_unique_address]] Stats stats_;
 };
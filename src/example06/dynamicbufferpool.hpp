@@ -0,0 +1,328 @@
+#pragma once
+
+#include "poolptr.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Runtime sized counterpart of LockFreeBufferPool. Storage is allocated in chunks of a fixed number of slots
+// (rounded up to a power of two), so a slot index splits into chunk/offset with a shift and a mask. When the
+// free list runs dry the pool grows by one whole chunk until maxChunks is reached. Chunks are never moved or
+// freed before the pool itself, so pointers handed out stay valid for the pool's lifetime. Every chunk is aligned
+// to its byte size rounded up to a power of two, so masking a slot address gives the chunk's base address, which
+// a fixed hash table maps back to the chunk number.
+template <typename T>
+class DynamicBufferPool
+{
+    static constexpr std::size_t kElementSize  = std::max(sizeof(T), sizeof(uint32_t));
+    static constexpr std::size_t kElementAlign = std::max(alignof(T), alignof(uint32_t));
+
+    static constexpr uint32_t kNull = UINT32_MAX;  // sentinel: "no next slot"
+
+    struct TaggedIndex
+    {
+        uint32_t index;
+        uint32_t tag;
+    };
+
+    static_assert(sizeof(TaggedIndex) == sizeof(uint64_t));
+
+    // Entry of the chunk hash table: chunk is written before base is published.
+    struct ChunkEntry
+    {
+        std::atomic<const uint8_t*> base{nullptr};
+        uint32_t                    chunk{kNull};
+    };
+
+    // Frees a chunk that has not been published yet.
+    struct ChunkDeleter
+    {
+        std::size_t alignment;
+
+        void
+        operator()(uint8_t* memory) const noexcept
+        {
+            ::operator delete(memory, std::align_val_t{alignment});
+        }
+    };
+
+public:
+    // maxChunks == 0 means "no growth", i.e. maxChunks == initialChunks.
+    explicit DynamicBufferPool(const std::size_t chunkSize,
+                               const std::size_t initialChunks = 1,
+                               const std::size_t maxChunks     = 0)
+      : chunkShift_{static_cast<uint32_t>(std::countr_zero(std::bit_ceil(std::max<std::size_t>(chunkSize, 1))))}
+      , chunkMask_{(uint32_t{1} << chunkShift_) - 1}
+      , maxChunks_{std::max(initialChunks, maxChunks)}
+      , chunkBytes_{(std::size_t{1} << chunkShift_) * kElementSize}
+      , chunkAlign_{std::bit_ceil(std::max(chunkBytes_, kElementAlign))}
+      , chunks_{std::make_unique<std::atomic<uint8_t*>[]>(maxChunks_)}
+      , indexMask_{std::bit_ceil(maxChunks_ * 2) - 1}
+      , index_{std::make_unique<ChunkEntry[]>(indexMask_ + 1)}
+    {
+        assert(maxChunks_ > 0);
+        assert((maxChunks_ << chunkShift_) <= UINT32_MAX && "capacity must fit in uint32_t");
+
+        head_.store(TaggedIndex{kNull, 0}, std::memory_order_relaxed);
+
+        // the destructor does not run when the constructor throws
+        try {
+            for (std::size_t i = 0; i < initialChunks; ++i) {
+                if (!grow(static_cast<uint32_t>(i))) {
+                    throw std::bad_alloc();
+                }
+            }
+        }
+        catch (...) {
+            freeChunks();
+            throw;
+        }
+    }
+
+    ~DynamicBufferPool()
+    {
+        freeChunks();
+    }
+
+    DynamicBufferPool(const DynamicBufferPool&)            = delete;
+    DynamicBufferPool& operator=(const DynamicBufferPool&) = delete;
+
+    T*
+    acquire()
+    {
+        TaggedIndex old_head = head_.load(std::memory_order_acquire);
+
+        while (true) {
+            if (old_head.index == kNull) {
+                const auto chunks = chunkCount_.load(std::memory_order_acquire);
+
+                if (chunks == maxChunks_ || !grow(chunks)) {
+                    return nullptr;
+                }
+
+                old_head = head_.load(std::memory_order_acquire);
+                continue;
+            }
+
+            TaggedIndex new_head;
+            new_head.index = next_of(old_head.index);
+            new_head.tag   = old_head.tag + 1;
+
+            if (head_.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return slot_ptr(old_head.index);
+            }
+        }
+    }
+
+    void
+    release(T* p)
+    {
+        const auto idx = index_of(p);
+
+        push_chain(idx, idx);
+    }
+
+    // Acquires a slot (growing if needed) and constructs T in it; the handle destroys and releases it.
+    template <typename... Args>
+    [[nodiscard]] PoolPtr<T, DynamicBufferPool>
+    make(Args&&... args)
+    {
+        return detail::makePooled<T>(*this, std::forward<Args>(args)...);
+    }
+
+    // Number of slots currently backed by memory.
+    [[nodiscard]] std::size_t
+    capacity() const noexcept
+    {
+        return static_cast<std::size_t>(chunkCount_.load(std::memory_order_acquire)) << chunkShift_;
+    }
+
+    [[nodiscard]] std::size_t
+    max_capacity() const noexcept
+    {
+        return maxChunks_ << chunkShift_;
+    }
+
+    [[nodiscard]] std::size_t
+    chunk_size() const noexcept
+    {
+        return std::size_t{1} << chunkShift_;
+    }
+
+    [[nodiscard]] bool
+    owns(const T* p) const noexcept
+    {
+        return find_chunk(reinterpret_cast<const uint8_t*>(p)) != kNull;
+    }
+
+private:
+    // Allocates chunk number `expected` unless another thread already did; returns false only when the pool
+    // is at its limit or the allocation failed.
+    bool
+    grow(const uint32_t expected)
+    {
+        const std::lock_guard<std::mutex> lock{growMutex_};
+
+        const auto chunk = chunkCount_.load(std::memory_order_relaxed);
+
+        if (chunk != expected) {
+            return true;
+        }
+
+        if (chunk == maxChunks_) {
+            return false;
+        }
+
+        std::unique_ptr<uint8_t, ChunkDeleter> memory{
+            static_cast<uint8_t*>(::operator new(chunkBytes_, std::align_val_t{chunkAlign_}, std::nothrow)),
+            ChunkDeleter{chunkAlign_}};
+
+        if (memory == nullptr) {
+            return false;
+        }
+
+        // The table has room for twice maxChunks entries, so the probe always finds a free one.
+        ChunkEntry* entry = &index_[slot_of(memory.get())];
+
+        while (entry->base.load(std::memory_order_relaxed) != nullptr) {
+            entry = &index_[(static_cast<std::size_t>(entry - index_.get()) + 1) & indexMask_];
+        }
+
+        entry->chunk = chunk;
+        entry->base.store(memory.get(), std::memory_order_release);
+        chunks_[chunk].store(memory.release(), std::memory_order_relaxed);
+        chunkCount_.store(chunk + 1, std::memory_order_release);
+
+        const uint32_t first = chunk << chunkShift_;
+        const uint32_t last  = first + chunkMask_;
+
+        for (uint32_t i = first; i < last; ++i) {
+            next_of(i) = i + 1;
+        }
+
+        push_chain(first, last);
+
+        return true;
+    }
+
+    // Links first..last (already chained through next_of) in front of the current head with a single CAS.
+    void
+    push_chain(const uint32_t first, const uint32_t last)
+    {
+        TaggedIndex old_head = head_.load(std::memory_order_acquire);
+
+        while (true) {
+            next_of(last) = old_head.index;
+
+            TaggedIndex new_head;
+            new_head.index = first;
+            new_head.tag   = old_head.tag + 1;
+
+            if (head_.compare_exchange_weak(old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
+    void
+    freeChunks() noexcept
+    {
+        const auto chunks = chunkCount_.load(std::memory_order_acquire);
+
+        for (uint32_t i = 0; i < chunks; ++i) {
+            ChunkDeleter{chunkAlign_}(chunks_[i].load(std::memory_order_relaxed));
+        }
+
+        for (std::size_t i = 0; i <= indexMask_; ++i) {
+            index_[i].base.store(nullptr, std::memory_order_relaxed);
+        }
+
+        chunkCount_.store(0, std::memory_order_release);
+    }
+
+    T*
+    slot_ptr(uint32_t idx) const
+    {
+        return reinterpret_cast<T*>(chunk_base(idx) + (kElementSize * (idx & chunkMask_)));
+    }
+
+    uint32_t&
+    next_of(uint32_t idx) const
+    {
+        return *reinterpret_cast<uint32_t*>(chunk_base(idx) + (kElementSize * (idx & chunkMask_)));
+    }
+
+    uint8_t*
+    chunk_base(uint32_t idx) const
+    {
+        return chunks_[idx >> chunkShift_].load(std::memory_order_relaxed);
+    }
+
+    // Home entry of a chunk base address in the hash table.
+    std::size_t
+    slot_of(const uint8_t* base) const noexcept
+    {
+        const uint64_t key = reinterpret_cast<uintptr_t>(base) / chunkAlign_;
+
+        return static_cast<std::size_t>((key * 0x9E37'79B9'7F4A'7C15ull) >> 32) & indexMask_;
+    }
+
+    // Masks p down to a chunk base and looks that up; kNull for a pointer outside the pool.
+    uint32_t
+    find_chunk(const uint8_t* p) const noexcept
+    {
+        const auto* base = reinterpret_cast<const uint8_t*>(reinterpret_cast<uintptr_t>(p) & ~(chunkAlign_ - 1));
+
+        if (p >= base + chunkBytes_) {
+            return kNull;
+        }
+
+        for (std::size_t i = slot_of(base);; i = (i + 1) & indexMask_) {
+            const uint8_t* entry = index_[i].base.load(std::memory_order_acquire);
+
+            if (entry == base) {
+                return index_[i].chunk;
+            }
+
+            if (entry == nullptr) {
+                return kNull;
+            }
+        }
+    }
+
+    uint32_t
+    index_of(const T* p) const
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(p);
+        const auto  chunk = find_chunk(bytes);
+        assert(chunk != kNull);
+
+        const auto offset = static_cast<std::size_t>(bytes - chunks_[chunk].load(std::memory_order_relaxed));
+        assert(offset % kElementSize == 0);
+
+        return (chunk << chunkShift_) | static_cast<uint32_t>(offset / kElementSize);
+    }
+
+    const uint32_t    chunkShift_;
+    const uint32_t    chunkMask_;
+    const std::size_t maxChunks_;
+    const std::size_t chunkBytes_;
+    const std::size_t chunkAlign_;
+
+    std::unique_ptr<std::atomic<uint8_t*>[]> chunks_;
+    std::atomic<uint32_t>                    chunkCount_{0};
+    const std::size_t                        indexMask_;
+    std::unique_ptr<ChunkEntry[]>            index_;  // chunk base -> chunk number, 2 * maxChunks rounded up
+    std::mutex                               growMutex_;
+
+    static constexpr std::size_t kCacheLineSize = 64;
+    alignas(kCacheLineSize) std::atomic<TaggedIndex> head_;
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "bufferpool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Default reset hook of ObjectPool: calls the object's own reset().
+struct ResetMember
+{
+    template <typename T>
+        requires requires(T& object) { object.reset(); }
+    void
+    operator()(T& object) const noexcept(noexcept(object.reset()))
+    {
+        object.reset();
+    }
+};
+
+// Hands the object back to its ObjectPool instead of destroying it.
+template <typename Pool>
+class RecycleDeleter
+{
+public:
+    RecycleDeleter() = default;
+
+    explicit RecycleDeleter(Pool* pool) noexcept
+      : pool_{pool}
+    {
+    }
+
+    template <typename T>
+    void
+    operator()(T* p) const noexcept
+    {
+        pool_->release(p);
+    }
+
+private:
+    Pool* pool_{nullptr};
+};
+
+template <typename T, typename Pool>
+using RecycledPtr = std::unique_ptr<T, RecycleDeleter<Pool>>;
+
+// Single-threaded pool of constructed objects on top of a lazy BufferPool. An object is default-constructed the
+// first time its slot is used and stays alive until the pool is destroyed; release() only runs the reset hook, so
+// strings and vectors inside the object keep their capacity and a warmed-up pool serves messages without touching
+// the heap. Reset must leave the object in a state the next user can fill, e.g. clear() rather than shrink.
+template <typename T, std::size_t N, typename Stats = NoPoolStats, typename Reset = ResetMember>
+class ObjectPool
+{
+    static_assert(std::is_nothrow_invocable_v<Reset&, T&>, "the reset hook must not throw");
+
+public:
+    explicit ObjectPool(Reset reset = Reset{})
+      : reset_{std::move(reset)}
+    {
+    }
+
+    ~ObjectPool()
+    {
+        if constexpr (Stats::kEnabled) {
+            stats_.report_leaks(leaked_objects());
+        }
+
+        for (std::size_t i = 0; i < constructed_; ++i) {
+            std::destroy_at(objects_[i]);
+        }
+    }
+
+    ObjectPool(const ObjectPool&)            = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // A recycled object if there is one, otherwise a freshly constructed one; nullptr when all N are in use.
+    T*
+    acquire()
+    {
+        if (freeCount_ > 0) {
+            stats_.on_acquire(N);
+            return free_[--freeCount_];
+        }
+
+        T* slot = storage_.acquire();
+
+        if (slot == nullptr) {
+            stats_.on_exhausted(N);
+            return nullptr;
+        }
+
+        try {
+            std::construct_at(slot);
+        }
+        catch (...) {
+            storage_.release(slot);
+            throw;
+        }
+
+        objects_[constructed_++] = slot;
+        stats_.on_acquire(N);
+
+        return slot;
+    }
+
+    void
+    release(T* p) noexcept
+    {
+        reset_(*p);
+        free_[freeCount_++] = p;
+        stats_.on_release();
+    }
+
+    // Same as acquire(); the handle recycles the object instead of destroying it. Empty when exhausted.
+    [[nodiscard]] RecycledPtr<T, ObjectPool>
+    make()
+    {
+        return RecycledPtr<T, ObjectPool>{acquire(), RecycleDeleter<ObjectPool>{this}};
+    }
+
+    // Objects constructed so far; only these ever hold heap buffers.
+    [[nodiscard]] std::size_t
+    constructed() const noexcept
+    {
+        return constructed_;
+    }
+
+    [[nodiscard]] const Stats&
+    stats() const noexcept
+    {
+        return stats_;
+    }
+
+    [[nodiscard]] Stats&
+    stats() noexcept
+    {
+        return stats_;
+    }
+
+private:
+    // Objects (by construction order) that are not back in the pool.
+    std::vector<std::size_t>
+    leaked_objects() const
+    {
+        std::vector<T*> free(free_.begin(), free_.begin() + static_cast<std::ptrdiff_t>(freeCount_));
+        std::sort(free.begin(), free.end());
+
+        std::vector<std::size_t> leaked;
+
+        for (std::size_t i = 0; i < constructed_; ++i) {
+            if (!std::binary_search(free.begin(), free.end(), objects_[i])) {
+                leaked.push_back(i);
+            }
+        }
+
+        return leaked;
+    }
+
+    BufferPool<T, N> storage_{PoolInit::kLazy};
+
+    // Both arrays fill up as objects are constructed; left uninitialized like the slots themselves.
+    std::array<T*, N> objects_;
+    std::array<T*, N> free_;
+    std::size_t       constructed_{0};
+    std::size_t       freeCount_{0};
+
+    [[no_unique_address]] Reset reset_;
+    [[no_unique_address]] Stats stats_;
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Destroys the object and hands its slot back to the pool it came from.
+template <typename Pool>
+class PoolDeleter
+{
+public:
+    PoolDeleter() = default;
+
+    explicit PoolDeleter(Pool* pool) noexcept
+      : pool_{pool}
+    {
+    }
+
+    template <typename T>
+    void
+    operator()(T* p) const noexcept
+    {
+        std::destroy_at(p);
+        pool_->release(p);
+    }
+
+private:
+    Pool* pool_{nullptr};
+};
+
+template <typename T, typename Pool>
+using PoolPtr = std::unique_ptr<T, PoolDeleter<Pool>>;
+
+namespace detail
+{
+// Constructs a T in a freshly acquired slot. An empty handle means the pool is exhausted; if the constructor
+// throws, the slot is released before the exception propagates.
+template <typename T, typename Pool, typename... Args>
+PoolPtr<T, Pool>
+makePooled(Pool& pool, Args&&... args)
+{
+    T* p = pool.acquire();
+
+    if (p == nullptr) {
+        return PoolPtr<T, Pool>{nullptr, PoolDeleter<Pool>{&pool}};
+    }
+
+    try {
+        std::construct_at(p, std::forward<Args>(args)...);
+    }
+    catch (...) {
+        pool.release(p);
+        throw;
+    }
+
+    return PoolPtr<T, Pool>{p, PoolDeleter<Pool>{&pool}};
+}
+}  // namespace detail
+
+// Pool element for SharedBuffer: the reference count lives next to the payload, so sharing costs no extra
+// allocation. Use a pool of SharedSlot<T>, e.g. LockFreeBufferPool<SharedSlot<Message>, 1024>.
+template <typename T>
+struct SharedSlot
+{
+    template <typename... Args>
+    explicit SharedSlot(Args&&... args)
+      : value(std::forward<Args>(args)...)
+    {
+    }
+
+    std::atomic<uint32_t> refs{1};
+    T                     value;
+};
+
+// Intrusively ref-counted handle to a pooled T. Copies share the payload; the last one destroys it and releases
+// the slot. Two pointers wide, so it can be pushed through the ring buffers in place of the payload.
+template <typename T, typename Pool>
+class SharedBuffer
+{
+public:
+    using Slot = SharedSlot<T>;
+
+    static_assert(std::is_same_v<decltype(std::declval<Pool&>().acquire()), Slot*>,
+                  "Pool must hand out SharedSlot<T>");
+
+    SharedBuffer() = default;
+
+    template <typename... Args>
+    [[nodiscard]] static SharedBuffer
+    make(Pool& pool, Args&&... args)
+    {
+        auto slot = detail::makePooled<Slot>(pool, std::forward<Args>(args)...);
+
+        return SharedBuffer{slot.release(), &pool};
+    }
+
+    SharedBuffer(const SharedBuffer& other) noexcept
+      : slot_{other.slot_}
+      , pool_{other.pool_}
+    {
+        if (slot_ != nullptr) {
+            slot_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedBuffer(SharedBuffer&& other) noexcept
+      : slot_{std::exchange(other.slot_, nullptr)}
+      , pool_{std::exchange(other.pool_, nullptr)}
+    {
+    }
+
+    SharedBuffer&
+    operator=(const SharedBuffer& other) noexcept
+    {
+        if (this != &other) {
+            SharedBuffer{other}.swap(*this);
+        }
+
+        return *this;
+    }
+
+    SharedBuffer&
+    operator=(SharedBuffer&& other) noexcept
+    {
+        SharedBuffer{std::move(other)}.swap(*this);
+
+        return *this;
+    }
+
+    ~SharedBuffer()
+    {
+        reset();
+    }
+
+    void
+    reset() noexcept
+    {
+        if (slot_ != nullptr && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::destroy_at(slot_);
+            pool_->release(slot_);
+        }
+
+        slot_ = nullptr;
+        pool_ = nullptr;
+    }
+
+    void
+    swap(SharedBuffer& other) noexcept
+    {
+        std::swap(slot_, other.slot_);
+        std::swap(pool_, other.pool_);
+    }
+
+    [[nodiscard]] T*
+    get() const noexcept
+    {
+        return slot_ != nullptr ? &slot_->value : nullptr;
+    }
+
+    T&
+    operator*() const noexcept
+    {
+        return slot_->value;
+    }
+
+    T*
+    operator->() const noexcept
+    {
+        return &slot_->value;
+    }
+
+    explicit
+    operator bool() const noexcept
+    {
+        return slot_ != nullptr;
+    }
+
+    [[nodiscard]] uint32_t
+    use_count() const noexcept
+    {
+        return slot_ != nullptr ? slot_->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    SharedBuffer(Slot* slot, Pool* pool) noexcept
+      : slot_{slot}
+      , pool_{slot != nullptr ? pool : nullptr}
+    {
+    }
+
+    Slot* slot_{nullptr};
+    Pool* pool_{nullptr};
+};
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <utility>
+
+struct PoolStatsSnapshot
+{
+    uint64_t acquires{0};
+    uint64_t releases{0};
+    uint64_t exhaustions{0};  // acquire() returned nullptr
+    uint64_t casRetries{0};
+    uint64_t inUse{0};
+    uint64_t peakInUse{0};
+};
+
+// Default statistics policy of the pools: every hook compiles away.
+class NoPoolStats
+{
+public:
+    static constexpr bool kEnabled = false;
+
+    void
+    on_acquire(std::size_t /*capacity*/) noexcept
+    {
+    }
+
+    void
+    on_release() noexcept
+    {
+    }
+
+    void
+    on_exhausted(std::size_t /*capacity*/) noexcept
+    {
+    }
+
+    void
+    on_cas_retries(uint32_t /*retries*/) noexcept
+    {
+    }
+
+    void
+    report_leaks(std::span<const std::size_t> /*slots*/) const
+    {
+    }
+};
+
+// Counting policy. Counters are sharded per thread (threads are spread round-robin over kShards cache lines), so
+// counting never touches the pool's head line and threads rarely share a counter line. The slots in use are the
+// exception: one exact running count, next to the peak it raises, so no burst is missed between samples.
+class PoolStats
+{
+public:
+    static constexpr bool kEnabled = true;
+
+    using LeakHandler = std::function<void(const PoolStatsSnapshot&, std::span<const std::size_t>)>;
+
+    PoolStats() = default;
+
+    PoolStats(const PoolStats&)            = delete;
+    PoolStats& operator=(const PoolStats&) = delete;
+
+    void
+    on_acquire(std::size_t /*capacity*/) noexcept
+    {
+        local().acquires.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t inUse = inUse_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        if (inUse > peak_.load(std::memory_order_relaxed)) {
+            raise_peak(inUse);
+        }
+    }
+
+    void
+    on_release() noexcept
+    {
+        local().releases.fetch_add(1, std::memory_order_relaxed);
+        inUse_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void
+    on_exhausted(const std::size_t capacity) noexcept
+    {
+        local().exhaustions.fetch_add(1, std::memory_order_relaxed);
+        raise_peak(capacity);
+    }
+
+    void
+    on_cas_retries(const uint32_t retries) noexcept
+    {
+        local().casRetries.fetch_add(retries, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] PoolStatsSnapshot
+    snapshot() const noexcept
+    {
+        PoolStatsSnapshot result;
+
+        for (const auto& shard : shards_) {
+            result.acquires += shard.acquires.load(std::memory_order_relaxed);
+            result.releases += shard.releases.load(std::memory_order_relaxed);
+            result.exhaustions += shard.exhaustions.load(std::memory_order_relaxed);
+            result.casRetries += shard.casRetries.load(std::memory_order_relaxed);
+        }
+
+        result.inUse     = inUse_.load(std::memory_order_relaxed);
+        result.peakInUse = std::max(peak_.load(std::memory_order_relaxed), result.inUse);
+
+        return result;
+    }
+
+    // Called from the pool's destructor; the default handler prints to std::cerr.
+    void
+    set_leak_handler(LeakHandler handler)
+    {
+        leakHandler_ = std::move(handler);
+    }
+
+    void
+    report_leaks(std::span<const std::size_t> slots) const
+    {
+        if (slots.empty()) {
+            return;
+        }
+
+        if (leakHandler_) {
+            leakHandler_(snapshot(), slots);
+            return;
+        }
+
+        std::cerr << "BufferPool: " << slots.size() << " slot(s) never released:";
+
+        for (const auto slot : slots) {
+            std::cerr << ' ' << slot;
+        }
+
+        std::cerr << '\n';
+    }
+
+private:
+    static constexpr std::size_t kShards        = 16;
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    struct alignas(kCacheLineSize) Shard
+    {
+        std::atomic<uint64_t> acquires{0};
+        std::atomic<uint64_t> releases{0};
+        std::atomic<uint64_t> exhaustions{0};
+        std::atomic<uint64_t> casRetries{0};
+    };
+
+    Shard&
+    local() noexcept
+    {
+        static std::atomic<std::size_t> nextShard{0};
+        thread_local const std::size_t  shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShards;
+
+        return shards_[shard];
+    }
+
+    void
+    raise_peak(const uint64_t value) noexcept
+    {
+        uint64_t peak = peak_.load(std::memory_order_relaxed);
+
+        while (peak < value && !peak_.compare_exchange_weak(peak, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::array<Shard, kShards> shards_;
+    LeakHandler                leakHandler_;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> inUse_{0};
+    std::atomic<uint64_t>                         peak_{0};
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "dynamicbufferpool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace detail
+{
+template <std::size_t Size>
+struct alignas(std::min<std::size_t>(Size, 64)) SlabBlock
+{
+    std::byte data[Size];
+};
+
+struct SlabConfig
+{
+    std::size_t chunkBytes;
+    std::size_t maxChunks;
+};
+
+template <std::size_t Size>
+struct SlabClass
+{
+    explicit SlabClass(const SlabConfig& config)
+      : pool{std::max<std::size_t>(config.chunkBytes / Size, 1), 0, config.maxChunks}
+    {
+    }
+
+    DynamicBufferPool<SlabBlock<Size>> pool;
+};
+
+template <typename Sequence>
+struct SlabClasses;
+
+template <std::size_t... Is>
+struct SlabClasses<std::index_sequence<Is...>>
+{
+    using Type = std::tuple<SlabClass<std::size_t{16} << Is>...>;
+};
+}  // namespace detail
+
+// Power-of-two size classes from 16 to 4096 bytes, one lock-free pool per class. Blocks are aligned to their
+// size up to a cache line, so a request is served from the smallest class that covers both its size and its
+// alignment.
+class SlabAllocator
+{
+public:
+    static constexpr std::size_t kMinBlockSize = 16;
+    static constexpr std::size_t kMaxBlockSize = 4096;
+    static constexpr std::size_t kMaxAlignment = 64;
+    static constexpr std::size_t kClassCount   = std::countr_zero(kMaxBlockSize / kMinBlockSize) + 1;
+
+    // Every class grows in chunks of chunkBytes, up to maxChunksPerClass chunks; nothing is allocated up front.
+    explicit SlabAllocator(const std::size_t chunkBytes = 64 * 1024, const std::size_t maxChunksPerClass = 64)
+      : SlabAllocator{detail::SlabConfig{chunkBytes, maxChunksPerClass}, std::make_index_sequence<kClassCount>{}}
+    {
+    }
+
+    SlabAllocator(const SlabAllocator&)            = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+    [[nodiscard]] static constexpr bool
+    fits(const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        return bytes <= kMaxBlockSize && alignment <= kMaxAlignment;
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    size_class(const std::size_t bytes, const std::size_t alignment) noexcept
+    {
+        const auto size = std::max({bytes, alignment, kMinBlockSize});
+
+        return static_cast<std::size_t>(std::countr_zero(std::bit_ceil(size)) - std::countr_zero(kMinBlockSize));
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    block_size(const std::size_t sizeClass) noexcept
+    {
+        return kMinBlockSize << sizeClass;
+    }
+
+    // Returns nullptr when the request does not fit a size class or the class is exhausted.
+    [[nodiscard]] void*
+    allocate(const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (!fits(bytes, alignment)) {
+            return nullptr;
+        }
+
+        return visit(size_class(bytes, alignment), [](auto& pool) -> void* {
+            return pool.acquire();
+        });
+    }
+
+    // Returns false when p was not allocated by this slab.
+    bool
+    deallocate(void* p, const std::size_t bytes, const std::size_t alignment = alignof(std::max_align_t))
+    {
+        if (!fits(bytes, alignment)) {
+            return false;
+        }
+
+        return visit(size_class(bytes, alignment), [p](auto& pool) -> bool {
+            using Block = std::remove_pointer_t<decltype(pool.acquire())>;
+
+            auto* block = static_cast<Block*>(p);
+
+            if (!pool.owns(block)) {
+                return false;
+            }
+
+            pool.release(block);
+
+            return true;
+        });
+    }
+
+private:
+    using Classes = detail::SlabClasses<std::make_index_sequence<kClassCount>>::Type;
+
+    template <std::size_t... Is>
+    SlabAllocator(const detail::SlabConfig& config, std::index_sequence<Is...>)
+      : classes_{(static_cast<void>(Is), config)...}
+    {
+    }
+
+    // Runtime class index to compile-time pool; every class lambda returns the same type.
+    template <typename F, typename Result = std::invoke_result_t<F&, DynamicBufferPool<detail::SlabBlock<kMinBlockSize>>&>>
+    Result
+    visit(const std::size_t sizeClass, F&& func)
+    {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            Result result{};
+
+            static_cast<void>(((sizeClass == Is && (result = func(std::get<Is>(classes_).pool), true)) || ...));
+
+            return result;
+        }(std::make_index_sequence<kClassCount>{});
+    }
+
+    Classes classes_;
+};
+
+// std::pmr adapter: small requests come from the slab, everything else (and anything a full size class cannot
+// serve) goes to the upstream resource.
+class SlabMemoryResource final : public std::pmr::memory_resource
+{
+public:
+    explicit SlabMemoryResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+                                const std::size_t          chunkBytes        = 64 * 1024,
+                                const std::size_t          maxChunksPerClass = 64)
+      : slab_{chunkBytes, maxChunksPerClass}
+      , upstream_{upstream}
+    {
+    }
+
+    SlabMemoryResource(const SlabMemoryResource&)            = delete;
+    SlabMemoryResource& operator=(const SlabMemoryResource&) = delete;
+
+    [[nodiscard]] std::pmr::memory_resource*
+    upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+private:
+    void*
+    do_allocate(const std::size_t bytes, const std::size_t alignment) override
+    {
+        if (void* p = slab_.allocate(bytes, alignment)) {
+            return p;
+        }
+
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void
+    do_deallocate(void* p, const std::size_t bytes, const std::size_t alignment) override
+    {
+        if (!slab_.deallocate(p, bytes, alignment)) {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+    }
+
+    [[nodiscard]] bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    SlabAllocator              slab_;
+    std::pmr::memory_resource* upstream_;
+};
@@ -0,0 +1,405 @@
+#include "example06/bitmapbufferpool.hpp"
+#include "example06/bufferpool.hpp"
+#include "example06/dynamicbufferpool.hpp"
+#include "example06/objectpool.hpp"
+#include "example06/ringbuffer.hpp"
+#include "example06/slaballocator.hpp"
+
+#include <benchmark/benchmark.h>
+#include <boost/lockfree/detail/freelist.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t kCapacity = 4096;  // slots in every fixed-size pool
+constexpr std::size_t kBatch    = 64;    // objects held at once by the single-threaded workload
+constexpr std::size_t kHeld     = 8;     // objects held at once by every thread of the contention workload
+constexpr std::size_t kMessages = 100'000;
+
+template <std::size_t Size>
+struct Object
+{
+    std::byte data[Size];
+};
+
+// Every allocator under test is wrapped into the same allocate()/deallocate() interface.
+
+template <std::size_t Size>
+class MallocAllocator
+{
+public:
+    void*
+    allocate()
+    {
+        return std::malloc(Size);
+    }
+
+    void
+    deallocate(void* p)
+    {
+        std::free(p);
+    }
+};
+
+template <std::size_t Size, typename Resource>
+class PmrAllocator
+{
+public:
+    void*
+    allocate()
+    {
+        return resource_.allocate(Size);
+    }
+
+    void
+    deallocate(void* p)
+    {
+        resource_.deallocate(p, Size);
+    }
+
+private:
+    Resource resource_;
+};
+
+template <std::size_t Size>
+using UnsynchronizedPoolAllocator = PmrAllocator<Size, std::pmr::unsynchronized_pool_resource>;
+
+template <std::size_t Size>
+using SynchronizedPoolAllocator = PmrAllocator<Size, std::pmr::synchronized_pool_resource>;
+
+template <std::size_t Size>
+using SlabResourceAllocator = PmrAllocator<Size, SlabMemoryResource>;
+
+// boost::lockfree's internal freelist (what its queue and stack allocate nodes from), unbounded.
+template <std::size_t Size>
+class BoostFreelistAllocator
+{
+public:
+    void*
+    allocate()
+    {
+        return freelist_.template construct<true, false>();
+    }
+
+    void
+    deallocate(void* p)
+    {
+        freelist_.template destruct<true>(static_cast<Object<Size>*>(p));
+    }
+
+private:
+    boost::lockfree::detail::freelist_stack<Object<Size>> freelist_{std::allocator<Object<Size>>{}, kCapacity};
+};
+
+template <std::size_t Size, template <typename, std::size_t, typename> class Pool>
+class FixedPoolAllocator
+{
+public:
+    void*
+    allocate()
+    {
+        return pool_.acquire();
+    }
+
+    void
+    deallocate(void* p)
+    {
+        pool_.release(static_cast<Object<Size>*>(p));
+    }
+
+private:
+    Pool<Object<Size>, kCapacity, NoPoolStats> pool_;
+};
+
+template <std::size_t Size>
+using BufferPoolAllocator = FixedPoolAllocator<Size, BufferPool>;
+
+template <std::size_t Size>
+using LockFreeBufferPoolAllocator = FixedPoolAllocator<Size, LockFreeBufferPool>;
+
+template <std::size_t Size>
+using BitmapBufferPoolAllocator = FixedPoolAllocator<Size, BitmapBufferPool>;
+
+template <std::size_t Size>
+class DynamicBufferPoolAllocator
+{
+public:
+    void*
+    allocate()
+    {
+        return pool_.acquire();
+    }
+
+    void
+    deallocate(void* p)
+    {
+        pool_.release(static_cast<Object<Size>*>(p));
+    }
+
+private:
+    DynamicBufferPool<Object<Size>> pool_{kCapacity / 4, 1, 4};
+};
+
+// Allocate a batch, free it again.
+template <typename Allocator>
+void
+BENCHMARK_SingleThread(benchmark::State& state)
+{
+    auto allocator = std::make_unique<Allocator>();
+
+    std::array<void*, kBatch> ptrs{};
+
+    for (auto _ : state) {
+        for (auto& p : ptrs) {
+            p = allocator->allocate();
+        }
+
+        benchmark::DoNotOptimize(ptrs.data());
+
+        for (auto* p : ptrs) {
+            allocator->deallocate(p);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// Same batch through BitmapBufferPool's bulk interface: one sweep over the bitmap each way.
+template <std::size_t Size>
+void
+BENCHMARK_BitmapBulk(benchmark::State& state)
+{
+    auto pool = std::make_unique<BitmapBufferPool<Object<Size>, kCapacity>>();
+
+    std::array<Object<Size>*, kBatch> ptrs{};
+
+    for (auto _ : state) {
+        pool->acquire_n(ptrs);
+
+        benchmark::DoNotOptimize(ptrs.data());
+
+        pool->release_n(ptrs);
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// A message with heap-backed members, filled and dropped again in every batch.
+struct Message
+{
+    void
+    reset() noexcept
+    {
+        text.clear();
+        values.clear();
+    }
+
+    std::string           text;
+    std::vector<uint64_t> values;
+};
+
+void
+fillMessage(Message& message, const std::size_t i)
+{
+    message.text.assign(48, static_cast<char>('a' + (i % 26)));
+    message.values.assign(16, i);
+}
+
+void
+BENCHMARK_MessagesNewDelete(benchmark::State& state)
+{
+    std::array<std::unique_ptr<Message>, kBatch> messages;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            messages[i] = std::make_unique<Message>();
+            fillMessage(*messages[i], i);
+        }
+
+        benchmark::DoNotOptimize(messages.data());
+
+        for (auto& message : messages) {
+            message.reset();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// The slot comes from the pool but every message still constructs and frees its members.
+void
+BENCHMARK_MessagesBufferPool(benchmark::State& state)
+{
+    auto pool = std::make_unique<BufferPool<Message, kBatch>>();
+
+    std::array<PoolPtr<Message, BufferPool<Message, kBatch>>, kBatch> messages;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            messages[i] = pool->make();
+            fillMessage(*messages[i], i);
+        }
+
+        benchmark::DoNotOptimize(messages.data());
+
+        for (auto& message : messages) {
+            message.reset();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// Recycled messages keep their string and vector buffers: no heap traffic once warm.
+void
+BENCHMARK_MessagesObjectPool(benchmark::State& state)
+{
+    auto pool = std::make_unique<ObjectPool<Message, kBatch>>();
+
+    std::array<RecycledPtr<Message, ObjectPool<Message, kBatch>>, kBatch> messages;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            messages[i] = pool->make();
+            fillMessage(*messages[i], i);
+        }
+
+        benchmark::DoNotOptimize(messages.data());
+
+        for (auto& message : messages) {
+            message.reset();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kBatch));
+}
+
+// The producer allocates and hands the object over an SPSC ring, the consumer frees it.
+template <typename Allocator>
+void
+BENCHMARK_ProducerConsumer(benchmark::State& state)
+{
+    auto allocator = std::make_unique<Allocator>();
+
+    for (auto _ : state) {
+        SPSCRingBuffer<void*> ringBuffer(1 << 10);
+
+        std::thread producer{[&ringBuffer, &allocator]() {
+            for (size_t i = 0; i < kMessages;) {
+                if (void* p = allocator->allocate()) {
+                    ringBuffer.push(p);
+                    ++i;
+                }
+            }
+        }};
+
+        std::thread consumer{[&ringBuffer, &allocator]() {
+            size_t i = 0;
+
+            while (i < kMessages) {
+                if (void** p = ringBuffer.front()) {
+                    allocator->deallocate(*p);
+                    ringBuffer.pop();
+                    ++i;
+                }
+            }
+        }};
+
+        producer.join();
+        consumer.join();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kMessages));
+}
+
+// Every thread allocates and frees a few objects from one shared allocator.
+template <typename Allocator>
+void
+BENCHMARK_Contention(benchmark::State& state)
+{
+    static std::unique_ptr<Allocator> allocator;
+
+    if (state.thread_index() == 0) {
+        allocator = std::make_unique<Allocator>();
+    }
+
+    std::array<void*, kHeld> ptrs{};
+
+    for (auto _ : state) {
+        for (auto& p : ptrs) {
+            p = allocator->allocate();
+        }
+
+        benchmark::DoNotOptimize(ptrs.data());
+
+        for (auto* p : ptrs) {
+            allocator->deallocate(p);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kHeld));
+
+    if (state.thread_index() == 0) {
+        allocator.reset();
+    }
+}
+}  // namespace
+
+// Wall-clock time throughout: the producer/consumer workload runs its own threads.
+#define BENCHMARK_ALLOCATOR_SIZES(Benchmark, Allocator)                   \
+    BENCHMARK_TEMPLATE(Benchmark, Allocator<16>)->UseRealTime();          \
+    BENCHMARK_TEMPLATE(Benchmark, Allocator<64>)->UseRealTime();          \
+    BENCHMARK_TEMPLATE(Benchmark, Allocator<256>)->UseRealTime();         \
+    BENCHMARK_TEMPLATE(Benchmark, Allocator<1024>)->UseRealTime()
+
+#define BENCHMARK_CONTENTION_SIZES(Allocator)                                                  \
+    BENCHMARK_TEMPLATE(BENCHMARK_Contention, Allocator<16>)->ThreadRange(1, 8)->UseRealTime(); \
+    BENCHMARK_TEMPLATE(BENCHMARK_Contention, Allocator<256>)->ThreadRange(1, 8)->UseRealTime()
+
+// single-threaded allocators
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, MallocAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, UnsynchronizedPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, SynchronizedPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, BoostFreelistAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, BufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, LockFreeBufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, BitmapBufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, DynamicBufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_SingleThread, SlabResourceAllocator);
+BENCHMARK_TEMPLATE(BENCHMARK_BitmapBulk, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BitmapBulk, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BitmapBulk, 256)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BitmapBulk, 1024)->UseRealTime();
+
+BENCHMARK(BENCHMARK_MessagesNewDelete)->UseRealTime();
+BENCHMARK(BENCHMARK_MessagesBufferPool)->UseRealTime();
+BENCHMARK(BENCHMARK_MessagesObjectPool)->UseRealTime();
+
+// thread-safe allocators only
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, MallocAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, SynchronizedPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, BoostFreelistAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, LockFreeBufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, DynamicBufferPoolAllocator);
+BENCHMARK_ALLOCATOR_SIZES(BENCHMARK_ProducerConsumer, SlabResourceAllocator);
+
+BENCHMARK_CONTENTION_SIZES(MallocAllocator);
+BENCHMARK_CONTENTION_SIZES(SynchronizedPoolAllocator);
+BENCHMARK_CONTENTION_SIZES(BoostFreelistAllocator);
+BENCHMARK_CONTENTION_SIZES(LockFreeBufferPoolAllocator);
+BENCHMARK_CONTENTION_SIZES(DynamicBufferPoolAllocator);
+BENCHMARK_CONTENTION_SIZES(SlabResourceAllocator);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,215 @@
+#include "example02/executor.hpp"
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+namespace
+{
+using Backend       = executor::Executor::Backend;
+using PeriodicTimer = executor::Executor::PeriodicTimer;
+
+constexpr size_t kTasks     = 100'000;  // tasks per iteration
+constexpr size_t kFanOut    = 100;      // children spawned by every root task of the fan-out workload
+constexpr size_t kWorkUnits = 64;       // busy work per task, so there is something to spread over the cores
+
+void
+work(std::atomic<size_t>& done)
+{
+    size_t value = 0;
+
+    for (size_t i = 0; i < kWorkUnits; ++i) {
+        benchmark::DoNotOptimize(value += i);
+    }
+
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Every task is posted from outside the executor before it runs.
+template <Backend kBackend>
+void
+BENCHMARK_ExternalSpawn(benchmark::State& state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+
+    spdlog::set_level(spdlog::level::warn);  // the executor logs every start and stop at info
+
+    for (auto _ : state) {
+        executor::Executor  executor{executor::Executor::Options{.backend = kBackend, .shardsCount = threads}};
+        std::atomic<size_t> done{0};
+
+        for (size_t i = 0; i < kTasks; ++i) {
+            executor.spawn([&done]() {
+                work(done);
+            });
+        }
+
+        executor.run(threads);
+
+        benchmark::DoNotOptimize(done.load());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kTasks));
+}
+
+// Root tasks spawn their children from inside the executor: the path a work-stealing deque is built for.
+template <Backend kBackend>
+void
+BENCHMARK_FanOut(benchmark::State& state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+
+    spdlog::set_level(spdlog::level::warn);  // the executor logs every start and stop at info
+
+    for (auto _ : state) {
+        executor::Executor  executor{executor::Executor::Options{.backend = kBackend, .shardsCount = threads}};
+        std::atomic<size_t> done{0};
+
+        for (size_t i = 0; i < kTasks / kFanOut; ++i) {
+            executor.spawn([&executor, &done]() {
+                for (size_t c = 0; c < kFanOut - 1; ++c) {
+                    executor.spawn([&done]() {
+                        work(done);
+                    });
+                }
+
+                work(done);
+            });
+        }
+
+        executor.run(threads);
+
+        benchmark::DoNotOptimize(done.load());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kTasks));
+}
+
+// spawn() with and without a timeout: the cost of watching every task.
+template <bool kWatched>
+void
+BENCHMARK_WatchedSpawn(benchmark::State& state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+
+    spdlog::set_level(spdlog::level::warn);
+
+    for (auto _ : state) {
+        executor::Executor  executor{executor::Executor::Options{.backend = Backend::kWorkStealing}};
+        std::atomic<size_t> done{0};
+
+        for (size_t i = 0; i < kTasks / kFanOut; ++i) {
+            executor.spawn([&executor, &done]() {
+                for (size_t c = 0; c < kFanOut; ++c) {
+                    if constexpr (kWatched) {
+                        executor.spawn(std::chrono::seconds{1}, [&done]() {
+                            work(done);
+                        });
+                    }
+                    else {
+                        executor.spawn([&done]() {
+                            work(done);
+                        });
+                    }
+                }
+            });
+        }
+
+        executor.run(threads);
+
+        benchmark::DoNotOptimize(done.load());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kTasks));
+}
+
+// The watched fan-out of BENCHMARK_WatchedSpawn<true> as spawnBatch(): one watchdog interval and one wakeup round
+// per root instead of one per child.
+template <Backend kBackend>
+void
+BENCHMARK_BatchedFanOut(benchmark::State& state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+
+    spdlog::set_level(spdlog::level::warn);
+
+    for (auto _ : state) {
+        executor::Executor  executor{executor::Executor::Options{.backend = kBackend, .shardsCount = threads}};
+        std::atomic<size_t> done{0};
+
+        for (size_t i = 0; i < kTasks / kFanOut; ++i) {
+            executor.spawn([&executor, &done]() {
+                executor.spawnBatch(std::chrono::seconds{1},
+                                    std::views::iota(size_t{0}, kFanOut) | std::views::transform([&done](size_t) {
+                                        return [&done]() {
+                                            work(done);
+                                        };
+                                    }));
+            });
+        }
+
+        executor.run(threads);
+
+        benchmark::DoNotOptimize(done.load());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(kTasks));
+}
+
+// Many short-period tasks, each stopping itself after a few calls: the re-arm path of the periodic timers.
+template <PeriodicTimer kTimer>
+void
+BENCHMARK_PeriodicTasks(benchmark::State& state)
+{
+    constexpr size_t kCalls = 5;
+
+    const auto count = static_cast<size_t>(state.range(0));
+
+    spdlog::set_level(spdlog::level::err);  // the steady timers warn about every late expiry
+
+    for (auto _ : state) {
+        executor::Executor executor{executor::Executor::Options{.periodicTimer = kTimer}};
+
+        std::vector<std::shared_ptr<executor::Executor::PeriodicTask>> tasks(count);
+        std::vector<size_t>                                            calls(count, 0);
+
+        for (size_t i = 0; i < count; ++i) {
+            tasks[i] = executor.createPeriodicTask(
+                std::chrono::milliseconds{1},
+                [&tasks, &calls, i]() {
+                    if (++calls[i] == kCalls) {
+                        tasks[i]->stop();
+                    }
+                },
+                false);
+
+            tasks[i]->start();
+        }
+
+        executor.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count * kCalls));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BENCHMARK_ExternalSpawn, Backend::kAsio)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_ExternalSpawn, Backend::kWorkStealing)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_ExternalSpawn, Backend::kSharded)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_FanOut, Backend::kAsio)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_FanOut, Backend::kWorkStealing)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_FanOut, Backend::kSharded)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_WatchedSpawn, false)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_WatchedSpawn, true)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BatchedFanOut, Backend::kAsio)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BatchedFanOut, Backend::kWorkStealing)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_BatchedFanOut, Backend::kSharded)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_PeriodicTasks, PeriodicTimer::kSteadyTimer)->Range(1'000, 10'000)->UseRealTime();
+BENCHMARK_TEMPLATE(BENCHMARK_PeriodicTasks, PeriodicTimer::kTimerWheel)->Range(1'000, 10'000)->UseRealTime();
+
+BENCHMARK_MAIN();
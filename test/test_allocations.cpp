@@ -0,0 +1,249 @@
+#include "example02/coroutine.hpp"
+#include "example02/executor.hpp"
+#include "example02/smallfunction.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <ranges>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Every operator new of this binary goes through here, so a test can count the allocations of a code path.
+namespace
+{
+std::atomic<bool>   counting{false};
+std::atomic<size_t> allocations{0U};
+
+void*
+countedAllocate(const std::size_t size, const std::size_t alignment)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    // aligned_alloc wants a multiple of the alignment
+    const std::size_t rounded = (std::max<std::size_t>(size, 1U) + alignment - 1U) / alignment * alignment;
+
+    if (void* p = std::aligned_alloc(alignment, rounded)) {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+// Counts the allocations made while it is alive.
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+    {
+        allocations.store(0U);
+        counting.store(true);
+    }
+
+    ~AllocationCounter()
+    {
+        counting.store(false);
+    }
+
+    AllocationCounter(const AllocationCounter&)            = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    [[nodiscard]] size_t
+    count() const
+    {
+        return allocations.load();
+    }
+};
+}  // namespace
+
+void*
+operator new(const std::size_t size)
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void*
+operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+    std::free(p);
+}
+
+namespace executor
+{
+
+TEST(SmallFunctionTest, smallCallablesStayInline)
+{
+    size_t calls = 0U;
+
+    {
+        const AllocationCounter counter;
+
+        SmallFunction<void()> function{[&calls]() {
+            ++calls;
+        }};
+
+        SmallFunction<void()> moved{std::move(function)};
+        moved();
+
+        EXPECT_FALSE(function);
+        EXPECT_EQ(counter.count(), 0U);
+    }
+
+    // too big for the buffer: one allocation, and the callable still works after a move
+    struct Big
+    {
+        std::array<std::byte, 128> payload{};
+        size_t*                    calls;
+
+        void
+        operator()() const
+        {
+            ++*calls;
+        }
+    };
+
+    const AllocationCounter counter;
+
+    SmallFunction<void()> big{Big{{}, &calls}};
+    SmallFunction<void()> moved;
+    moved = std::move(big);
+    moved();
+
+    EXPECT_EQ(counter.count(), 1U);
+    EXPECT_EQ(calls, 2U);
+}
+
+class AllocationTest : public testing::TestWithParam<Executor::Backend>
+{
+};
+
+Task<int>
+sleepAndCount(Executor& executor, std::atomic<size_t>& done)
+{
+    co_await executor.sleep_for(1ms);
+    co_await executor.schedule();
+
+    done.fetch_add(1U);
+    co_return 1;
+}
+
+TEST_P(AllocationTest, postingDoesNotAllocate)
+{
+    constexpr size_t kTasks = 1'000U;
+
+    Executor executor{Executor::Options{.backend = GetParam(), .shardsCount = 2U}};
+
+    std::atomic<size_t>           done{0U};
+    std::vector<std::future<int>> futures;
+    std::vector<Future<int>>      chained;
+    std::vector<Future<int>>      coroutines;
+    futures.reserve(kTasks);
+    chained.reserve(kTasks);
+    coroutines.reserve(kTasks);
+
+    const auto postAll = [&]() {
+        for (size_t i{0U}; i < kTasks; ++i) {
+            executor.spawn([&done]() {
+                done.fetch_add(1U);
+            });
+
+            executor.spawn(1s, [&done]() {
+                done.fetch_add(1U);
+            });
+
+            futures.push_back(executor.post(1s, [&done]() -> int {
+                done.fetch_add(1U);
+                return 1;
+            }));
+
+            chained.push_back(executor.submit(1s, [&done]() -> int {
+                                          done.fetch_add(1U);
+                                          return 1;
+                                      })
+                                  .then([&done](int value) {
+                                      done.fetch_add(1U);
+                                      return value + 1;
+                                  }));
+
+            coroutines.push_back(co_spawn(executor, 1s, sleepAndCount(executor, done)));
+        }
+
+        executor.spawnBatch(1s, std::views::iota(size_t{0U}, kTasks) | std::views::transform([&done](size_t) {
+                                    return [&done]() {
+                                        done.fetch_add(1U);
+                                    };
+                                }));
+    };
+
+    // The first round grows the pools, the second one reuses them.
+    postAll();
+    ASSERT_NO_THROW(executor.run(1U));
+    futures.clear();
+    chained.clear();
+    coroutines.clear();
+    executor.restart();
+
+    {
+        const AllocationCounter counter;
+
+        postAll();
+
+        EXPECT_EQ(counter.count(), 0U);
+    }
+
+    ASSERT_NO_THROW(executor.run(1U));
+
+    EXPECT_EQ(done.load(), 14U * kTasks);
+
+    for (auto& future : futures) {
+        EXPECT_EQ(future.get(), 1);
+    }
+
+    for (auto& future : chained) {
+        EXPECT_EQ(future.get(), 2);
+    }
+
+    for (auto& future : coroutines) {
+        EXPECT_EQ(future.get(), 1);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         AllocationTest,
+                         testing::Values(Executor::Backend::kAsio,
+                                         Executor::Backend::kWorkStealing,
+                                         Executor::Backend::kSharded));
+
+}  // namespace executor
@@ -1,11 +1,24 @@
 #include <gtest/gtest.h>
 
+#include "example06/arena.hpp"
+#include "example06/bitmapbufferpool.hpp"
 #include "example06/bufferpool.hpp"
+#include "example06/dynamicbufferpool.hpp"
+#include "example06/objectpool.hpp"
+#include "example06/ringbuffer.hpp"
+#include "example06/slaballocator.hpp"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <barrier>
+#include <map>
+#include <memory_resource>
 #include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -452,4 +465,1091 @@ TEST(BufferPoolTest, PingPongABA)
     EXPECT_EQ(count, kPoolSize);
 }
 
+// ---------------------------------------------------------------------------
+// 6. DynamicBufferPool: growth by whole chunks up to the limit
+//    Slots handed out before a grow must keep their address and contents.
+// ---------------------------------------------------------------------------
+
+TEST(DynamicBufferPoolTest, GrowsUpToLimit)
+{
+    constexpr std::size_t kChunkSize = 6;  // rounded up to 8
+    constexpr std::size_t kMaxChunks = 3;
+
+    DynamicBufferPool<Payload> pool(kChunkSize, 1, kMaxChunks);
+
+    EXPECT_EQ(pool.chunk_size(), 8U);
+    EXPECT_EQ(pool.capacity(), 8U);
+    EXPECT_EQ(pool.max_capacity(), 24U);
+
+    std::vector<Payload*> ptrs;
+
+    while (Payload* p = pool.acquire()) {
+        p->canary = Payload::kMagic;
+        p->value  = ptrs.size();
+        ptrs.push_back(p);
+    }
+
+    EXPECT_EQ(ptrs.size(), pool.max_capacity());
+    EXPECT_EQ(pool.capacity(), pool.max_capacity());
+
+    std::set<Payload*> unique(ptrs.begin(), ptrs.end());
+    EXPECT_EQ(unique.size(), ptrs.size());
+
+    for (std::size_t i = 0; i < ptrs.size(); ++i) {
+        EXPECT_TRUE(pool.owns(ptrs[i]));
+        EXPECT_EQ(ptrs[i]->canary, Payload::kMagic);
+        EXPECT_EQ(ptrs[i]->value, i);
+    }
+
+    Payload outside;
+    EXPECT_FALSE(pool.owns(&outside));
+
+    // Releasing into any chunk makes exactly that slot available again.
+    pool.release(ptrs[3]);
+    pool.release(ptrs[20]);
+
+    std::set<Payload*> again{pool.acquire(), pool.acquire()};
+    EXPECT_EQ(again, (std::set<Payload*>{ptrs[3], ptrs[20]}));
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    for (auto* p : ptrs) {
+        pool.release(p);
+    }
+}
+
+TEST(DynamicBufferPoolTest, FixedCapacityWithoutGrowth)
+{
+    DynamicBufferPool<Payload> pool(4, 2);
+
+    std::size_t count = 0;
+
+    while (pool.acquire() != nullptr) {
+        ++count;
+    }
+
+    EXPECT_EQ(count, 8U);
+    EXPECT_EQ(pool.capacity(), 8U);
+}
+
+// ---------------------------------------------------------------------------
+// 7. DynamicBufferPool: concurrent growth
+//    All threads start on a single chunk and race to grow the pool.
+// ---------------------------------------------------------------------------
+
+TEST(DynamicBufferPoolTest, ConcurrentGrowth)
+{
+    constexpr std::size_t kChunkSize  = 16;
+    constexpr std::size_t kMaxChunks  = 16;
+    constexpr std::size_t kNumThreads = 8;
+    constexpr std::size_t kIterations = 50'000;
+
+    DynamicBufferPool<Payload> pool(kChunkSize, 1, kMaxChunks);
+
+    std::atomic<bool> corruption_detected{false};
+
+    std::barrier sync_point(static_cast<std::ptrdiff_t>(kNumThreads));
+
+    auto worker = [&](std::size_t thread_id) {
+        sync_point.arrive_and_wait();
+
+        std::vector<Payload*> held;
+
+        for (std::size_t i = 0; i < kIterations; ++i) {
+            if (held.size() < (kChunkSize * kMaxChunks) / kNumThreads) {
+                if (Payload* p = pool.acquire()) {
+                    p->canary = Payload::kMagic;
+                    p->value  = thread_id;
+                    held.push_back(p);
+                }
+            }
+
+            if (!held.empty() && (i % 3 == 0)) {
+                Payload* p = held.back();
+                held.pop_back();
+
+                if (p->canary != Payload::kMagic || p->value != thread_id) {
+                    corruption_detected.store(true, std::memory_order_relaxed);
+                }
+
+                pool.release(p);
+            }
+        }
+
+        for (auto* p : held) {
+            pool.release(p);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+
+    for (std::size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_FALSE(corruption_detected.load());
+    EXPECT_LE(pool.capacity(), pool.max_capacity());
+
+    std::size_t count = 0;
+
+    while (pool.acquire() != nullptr) {
+        ++count;
+    }
+
+    EXPECT_EQ(count, pool.max_capacity());
+}
+
+// ---------------------------------------------------------------------------
+// 8. SlabMemoryResource: size classes and upstream fallback
+// ---------------------------------------------------------------------------
+
+// Upstream that counts what reaches it, so we can tell slab hits from misses.
+class CountingResource final : public std::pmr::memory_resource
+{
+public:
+    std::size_t allocations{0};
+    std::size_t deallocations{0};
+
+private:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void
+    do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(SlabAllocatorTest, SizeClasses)
+{
+    static_assert(SlabAllocator::kClassCount == 9);
+    static_assert(SlabAllocator::size_class(1, 1) == 0);
+    static_assert(SlabAllocator::size_class(16, 8) == 0);
+    static_assert(SlabAllocator::size_class(17, 8) == 1);
+    static_assert(SlabAllocator::size_class(8, 64) == 2);
+    static_assert(SlabAllocator::size_class(4096, 16) == 8);
+    static_assert(!SlabAllocator::fits(4097, 16));
+    static_assert(!SlabAllocator::fits(16, 128));
+
+    SlabAllocator slab;
+
+    for (std::size_t bytes = 1; bytes <= SlabAllocator::kMaxBlockSize; bytes *= 3) {
+        void* p = slab.allocate(bytes, 16);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 16, 0U);
+        EXPECT_TRUE(slab.deallocate(p, bytes, 16));
+    }
+
+    int outside = 0;
+    EXPECT_FALSE(slab.deallocate(&outside, sizeof(outside), alignof(int)));
+}
+
+TEST(SlabAllocatorTest, PmrContainersStayOffUpstream)
+{
+    CountingResource   upstream;
+    SlabMemoryResource resource{&upstream};
+
+    {
+        std::pmr::vector<std::pmr::string> strings{&resource};
+
+        // 64 strings * sizeof(pmr::string) still fits the 4096 byte class.
+        for (int i = 0; i < 64; ++i) {
+            strings.emplace_back("a string that does not fit the small buffer " + std::to_string(i));
+        }
+
+        EXPECT_EQ(strings[42], "a string that does not fit the small buffer 42");
+    }
+
+    EXPECT_EQ(upstream.allocations, 0U);
+
+    // Larger than the biggest class goes straight upstream.
+    void* large = resource.allocate(SlabAllocator::kMaxBlockSize + 1);
+    EXPECT_EQ(upstream.allocations, 1U);
+    resource.deallocate(large, SlabAllocator::kMaxBlockSize + 1);
+    EXPECT_EQ(upstream.deallocations, 1U);
+}
+
+TEST(SlabAllocatorTest, ExhaustedClassFallsBackUpstream)
+{
+    constexpr std::size_t kBlockSize = 1024;
+
+    CountingResource   upstream;
+    SlabMemoryResource resource{&upstream, 4 * kBlockSize, 1};
+
+    std::vector<void*> blocks;
+
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(resource.allocate(kBlockSize));
+    }
+
+    EXPECT_EQ(upstream.allocations, 2U);
+
+    for (void* p : blocks) {
+        resource.deallocate(p, kBlockSize);
+    }
+
+    EXPECT_EQ(upstream.deallocations, 2U);
+}
+
+// ---------------------------------------------------------------------------
+// 9. RAII handles: make() constructs in place and the handle destroys and
+//    releases, including when the constructor throws.
+// ---------------------------------------------------------------------------
+
+struct Tracked
+{
+    explicit Tracked(int& liveCount, bool fail = false)
+      : live{liveCount}
+    {
+        if (fail) {
+            throw std::runtime_error("construction failed");
+        }
+
+        ++live;
+    }
+
+    Tracked(const Tracked&)            = delete;
+    Tracked& operator=(const Tracked&) = delete;
+
+    ~Tracked()
+    {
+        --live;
+    }
+
+    int& live;
+};
+
+TEST(PoolPtrTest, MakeDestroysAndReleases)
+{
+    constexpr std::size_t kPoolSize = 2;
+
+    int                                    live = 0;
+    LockFreeBufferPool<Tracked, kPoolSize> pool;
+
+    {
+        auto a = pool.make(live);
+        auto b = pool.make(live);
+        ASSERT_TRUE(a && b);
+        EXPECT_EQ(live, 2);
+
+        auto c = pool.make(live);
+        EXPECT_FALSE(c);  // exhausted
+
+        a.reset();
+        EXPECT_EQ(live, 1);
+        EXPECT_TRUE(pool.make(live));  // slot is back and released again at end of statement
+    }
+
+    EXPECT_EQ(live, 0);
+
+    EXPECT_THROW(static_cast<void>(pool.make(live, true)), std::runtime_error);
+
+    // The slot of the failed construction was returned.
+    std::size_t count = 0;
+
+    while (pool.acquire() != nullptr) {
+        ++count;
+    }
+
+    EXPECT_EQ(count, kPoolSize);
+}
+
+TEST(PoolPtrTest, MakeOnAllPools)
+{
+    int live = 0;
+
+    BufferPool<Tracked, 1>     single;
+    DynamicBufferPool<Tracked> dynamic(1, 1, 2);
+
+    {
+        auto a = single.make(live);
+        auto b = dynamic.make(live);
+        auto c = dynamic.make(live);
+        EXPECT_TRUE(a && b && c);
+        EXPECT_FALSE(single.make(live));
+        EXPECT_EQ(live, 3);
+    }
+
+    EXPECT_EQ(live, 0);
+}
+
+// ---------------------------------------------------------------------------
+// 10. SharedBuffer: one pooled payload fanned out to several consumers
+//     through rings; the last reference returns the slot.
+// ---------------------------------------------------------------------------
+
+TEST(SharedBufferTest, FanOutThroughRings)
+{
+    using Pool   = LockFreeBufferPool<SharedSlot<std::string>, 4>;
+    using Buffer = SharedBuffer<std::string, Pool>;
+
+    constexpr std::size_t kConsumers = 3;
+    constexpr std::size_t kMessages  = 1'000;
+
+    static_assert(sizeof(Buffer) == 2 * sizeof(void*));
+
+    Pool pool;
+
+    std::vector<std::unique_ptr<SPSCRingBuffer<Buffer>>> rings;
+    for (std::size_t i = 0; i < kConsumers; ++i) {
+        rings.push_back(std::make_unique<SPSCRingBuffer<Buffer>>(8));
+    }
+
+    std::atomic<bool> corruption_detected{false};
+
+    std::vector<std::thread> consumers;
+    for (std::size_t i = 0; i < kConsumers; ++i) {
+        consumers.emplace_back([&ring = *rings[i], &corruption_detected]() {
+            for (std::size_t n = 0; n < kMessages;) {
+                if (Buffer* buffer = ring.front()) {
+                    if (**buffer != std::to_string(n) + " a payload that is too large for the small string buffer") {
+                        corruption_detected.store(true, std::memory_order_relaxed);
+                    }
+
+                    ring.pop();
+                    ++n;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (std::size_t n = 0; n < kMessages;) {
+        Buffer buffer = Buffer::make(pool, std::to_string(n) + " a payload that is too large for the small string buffer");
+
+        if (!buffer) {
+            std::this_thread::yield();  // all slots in flight, wait for the consumers
+            continue;
+        }
+
+        for (auto& ring : rings) {
+            ring->push(buffer);
+        }
+
+        ++n;
+    }
+
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_FALSE(corruption_detected.load());
+
+    std::size_t count = 0;
+
+    while (pool.acquire() != nullptr) {
+        ++count;
+    }
+
+    EXPECT_EQ(count, 4U);
+}
+
+TEST(SharedBufferTest, CopyMoveAndReset)
+{
+    using Pool   = BufferPool<SharedSlot<int>, 1>;
+    using Buffer = SharedBuffer<int, Pool>;
+
+    Pool pool;
+
+    Buffer a = Buffer::make(pool, 42);
+    ASSERT_TRUE(a);
+    EXPECT_FALSE(Buffer::make(pool, 0));
+
+    Buffer b = a;
+    EXPECT_EQ(a.use_count(), 2U);
+    EXPECT_EQ(*b, 42);
+
+    Buffer c = std::move(a);
+    EXPECT_FALSE(a);
+    EXPECT_EQ(c.use_count(), 2U);
+
+    b.reset();
+    EXPECT_EQ(c.use_count(), 1U);
+    EXPECT_FALSE(Buffer::make(pool, 0));
+
+    c = Buffer{};
+    EXPECT_TRUE(Buffer::make(pool, 0));
+}
+
+// ---------------------------------------------------------------------------
+// 11. Generational handles: stale handles stop resolving once the slot is
+//     released, even if the same slot has been handed out again.
+// ---------------------------------------------------------------------------
+
+TEST(PoolHandleTest, StaleHandlesDoNotResolve)
+{
+    using Pool = LockFreeBufferPool<Payload, 2>;
+
+    Pool pool;
+
+    static_assert(sizeof(Pool::Handle) == sizeof(uint64_t));
+
+    Pool::Handle a = pool.acquire_handle();
+    ASSERT_TRUE(a);
+
+    Payload* p = pool.resolve(a);
+    ASSERT_NE(p, nullptr);
+    p->value = 1;
+
+    pool.release(a);
+    EXPECT_EQ(pool.resolve(a), nullptr);
+
+    // LIFO free list: the same slot comes back with a new generation.
+    Pool::Handle b = pool.acquire_handle();
+    EXPECT_EQ(b.index, a.index);
+    EXPECT_NE(b.generation, a.generation);
+    EXPECT_EQ(pool.resolve(a), nullptr);
+    EXPECT_EQ(pool.resolve(b), p);
+
+    // Releasing through the raw pointer invalidates handles as well.
+    pool.release(pool.resolve(b));
+    EXPECT_EQ(pool.resolve(b), nullptr);
+
+    EXPECT_EQ(pool.resolve(Pool::Handle{}), nullptr);
+
+    Pool::Handle c = pool.acquire_handle();
+    Pool::Handle d = pool.acquire_handle();
+    EXPECT_TRUE(c && d);
+    EXPECT_FALSE(pool.acquire_handle());
+    pool.release(c);
+    pool.release(d);
+}
+
+TEST(PoolHandleTest, HandlesThroughMPMCRing)
+{
+    using Pool = LockFreeBufferPool<Payload, 64>;
+
+    constexpr std::size_t kMessages = 20'000;
+
+    Pool                         pool;
+    MPMCRingBuffer<Pool::Handle> ring(16);
+
+    std::atomic<bool> corruption_detected{false};
+
+    std::thread consumer{[&]() {
+        Pool::Handle handle;
+
+        for (std::size_t i = 0; i < kMessages; ++i) {
+            ring.pop(handle);
+
+            Payload* p = pool.resolve(handle);
+
+            if (p == nullptr || p->canary != Payload::kMagic || p->value != i) {
+                corruption_detected.store(true, std::memory_order_relaxed);
+            }
+
+            pool.release(handle);
+        }
+    }};
+
+    for (std::size_t i = 0; i < kMessages;) {
+        Pool::Handle handle = pool.acquire_handle();
+
+        if (!handle) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        Payload* p = pool.resolve(handle);
+        ASSERT_NE(p, nullptr);
+
+        p->canary = Payload::kMagic;
+        p->value  = i++;
+
+        ring.push(handle);
+    }
+
+    consumer.join();
+
+    EXPECT_FALSE(corruption_detected.load());
+}
+
+// ---------------------------------------------------------------------------
+// 12. Statistics policy: counters, peak, exhaustion and the leak report.
+// ---------------------------------------------------------------------------
+
+TEST(PoolStatsTest, CountsAndLeakReport)
+{
+    constexpr std::size_t kPoolSize = 4;
+
+    std::vector<std::size_t> leaked;
+    PoolStatsSnapshot        atDestruction;
+
+    {
+        LockFreeBufferPool<Payload, kPoolSize, PoolStats> pool;
+
+        pool.stats().set_leak_handler([&](const PoolStatsSnapshot& snapshot, std::span<const std::size_t> slots) {
+            atDestruction = snapshot;
+            leaked.assign(slots.begin(), slots.end());
+        });
+
+        std::vector<Payload*> ptrs;
+
+        while (Payload* p = pool.acquire()) {
+            ptrs.push_back(p);
+        }
+
+        pool.release(ptrs[0]);
+        pool.release(ptrs[2]);
+
+        const auto snapshot = pool.stats().snapshot();
+        EXPECT_EQ(snapshot.acquires, kPoolSize);
+        EXPECT_EQ(snapshot.releases, 2U);
+        EXPECT_EQ(snapshot.exhaustions, 1U);
+        EXPECT_EQ(snapshot.inUse, 2U);
+        EXPECT_EQ(snapshot.peakInUse, kPoolSize);
+    }
+
+    // The free list is LIFO from slot 0, so acquisition order equals slot order.
+    EXPECT_EQ(leaked, (std::vector<std::size_t>{1, 3}));
+    EXPECT_EQ(atDestruction.inUse, 2U);
+}
+
+TEST(PoolStatsTest, PeakCountsShortBursts)
+{
+    LockFreeBufferPool<Payload, 8, PoolStats> pool;
+
+    // a burst far shorter than any sampling interval, and fully released before the snapshot
+    std::array<Payload*, 3> burst{pool.acquire(), pool.acquire(), pool.acquire()};
+
+    for (Payload* p : burst) {
+        pool.release(p);
+    }
+
+    const auto snapshot = pool.stats().snapshot();
+    EXPECT_EQ(snapshot.inUse, 0U);
+    EXPECT_EQ(snapshot.peakInUse, 3U);
+}
+
+TEST(PoolStatsTest, SingleThreadedPool)
+{
+    bool reported = false;
+
+    {
+        BufferPool<Payload, 2, PoolStats> pool;
+
+        pool.stats().set_leak_handler([&](const PoolStatsSnapshot&, std::span<const std::size_t>) {
+            reported = true;
+        });
+
+        Payload* p = pool.acquire();
+        pool.release(p);
+
+        const auto snapshot = pool.stats().snapshot();
+        EXPECT_EQ(snapshot.acquires, 1U);
+        EXPECT_EQ(snapshot.releases, 1U);
+        EXPECT_EQ(snapshot.exhaustions, 0U);
+        EXPECT_EQ(snapshot.inUse, 0U);
+    }
+
+    EXPECT_FALSE(reported);
+
+    static_assert(sizeof(BufferPool<Payload, 2>) == (2 * sizeof(Payload)) + sizeof(void*) + sizeof(std::size_t),
+                  "NoPoolStats must not take space");
+}
+
+TEST(PoolStatsTest, ConcurrentCountersAddUp)
+{
+    constexpr std::size_t kPoolSize   = 16;
+    constexpr std::size_t kNumThreads = 8;
+    constexpr std::size_t kIterations = 20'000;
+
+    LockFreeBufferPool<Payload, kPoolSize, PoolStats> pool;
+
+    std::barrier sync_point(static_cast<std::ptrdiff_t>(kNumThreads));
+
+    auto worker = [&]() {
+        sync_point.arrive_and_wait();
+
+        for (std::size_t i = 0; i < kIterations; ++i) {
+            if (Payload* p = pool.acquire()) {
+                pool.release(p);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const auto snapshot = pool.stats().snapshot();
+    EXPECT_EQ(snapshot.acquires + snapshot.exhaustions, kNumThreads * kIterations);
+    EXPECT_EQ(snapshot.acquires, snapshot.releases);
+    EXPECT_EQ(snapshot.inUse, 0U);
+    EXPECT_LE(snapshot.peakInUse, kPoolSize);
+}
+
+// ---------------------------------------------------------------------------
+// 13. BitmapBufferPool: lowest free slot first, bulk acquire/release in one
+//     sweep, and iteration over the live slots in address order.
+// ---------------------------------------------------------------------------
+
+TEST(BitmapBufferPoolTest, LowestFreeSlotFirst)
+{
+    constexpr std::size_t kPoolSize = 200;  // not a multiple of the bitmap word
+
+    BitmapBufferPool<Payload, kPoolSize> pool;
+
+    std::vector<Payload*> ptrs;
+
+    for (std::size_t i = 0; i < kPoolSize; ++i) {
+        ptrs.push_back(pool.acquire());
+        ASSERT_NE(ptrs.back(), nullptr);
+
+        if (i > 0) {
+            EXPECT_EQ(ptrs[i], ptrs[i - 1] + 1) << "slots must be handed out in address order";
+        }
+    }
+
+    EXPECT_EQ(pool.acquire(), nullptr);
+    EXPECT_EQ(pool.in_use(), kPoolSize);
+
+    pool.release(ptrs[150]);
+    pool.release(ptrs[3]);
+    pool.release(ptrs[70]);
+
+    EXPECT_EQ(pool.acquire(), ptrs[3]);
+    EXPECT_EQ(pool.acquire(), ptrs[70]);
+    EXPECT_EQ(pool.acquire(), ptrs[150]);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    for (auto* p : ptrs) {
+        pool.release(p);
+    }
+
+    EXPECT_EQ(pool.in_use(), 0U);
+}
+
+TEST(BitmapBufferPoolTest, BulkAcquireRelease)
+{
+    constexpr std::size_t kPoolSize = 300;
+
+    BitmapBufferPool<Payload, kPoolSize, PoolStats> pool;
+
+    std::array<Payload*, 100> batch{};
+
+    ASSERT_EQ(pool.acquire_n(batch), batch.size());
+
+    for (std::size_t i = 1; i < batch.size(); ++i) {
+        EXPECT_EQ(batch[i], batch[i - 1] + 1);
+    }
+
+    std::array<Payload*, 250> big{};
+    EXPECT_EQ(pool.acquire_n(big), kPoolSize - batch.size()) << "partial batch when the pool runs dry";
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    std::set<Payload*> unique(batch.begin(), batch.end());
+    unique.insert(big.begin(), big.begin() + static_cast<std::ptrdiff_t>(kPoolSize - batch.size()));
+    EXPECT_EQ(unique.size(), kPoolSize);
+
+    pool.release_n(batch);
+    EXPECT_EQ(pool.in_use(), kPoolSize - batch.size());
+
+    std::array<Payload*, 10> again{};
+    ASSERT_EQ(pool.acquire_n(again), again.size());
+    EXPECT_EQ(again[0], batch[0]) << "bulk acquire also starts from the lowest free slot";
+
+    pool.release_n(again);
+    pool.release_n(std::span<Payload* const>{big.data(), kPoolSize - batch.size()});
+
+    const auto snapshot = pool.stats().snapshot();
+    EXPECT_EQ(snapshot.acquires, kPoolSize + again.size());
+    EXPECT_EQ(snapshot.releases, kPoolSize + again.size());
+    EXPECT_EQ(snapshot.exhaustions, 2U);
+    EXPECT_EQ(snapshot.inUse, 0U);
+}
+
+TEST(BitmapBufferPoolTest, IteratesLiveSlots)
+{
+    BitmapBufferPool<Payload, 130> pool;
+
+    std::vector<PoolPtr<Payload, BitmapBufferPool<Payload, 130>>> live;
+
+    for (uint64_t i = 0; i < 130; ++i) {
+        live.push_back(pool.make(Payload{Payload::kMagic, i}));
+    }
+
+    // Drop every third object, the sweep must skip their slots.
+    for (std::size_t i = 0; i < live.size(); i += 3) {
+        live[i].reset();
+    }
+
+    std::vector<uint64_t> seen;
+
+    pool.for_each_live([&](Payload& payload) {
+        EXPECT_EQ(payload.canary, Payload::kMagic);
+        seen.push_back(payload.value);
+    });
+
+    ASSERT_EQ(seen.size(), pool.in_use());
+    EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+    EXPECT_TRUE(std::none_of(seen.begin(), seen.end(), [](uint64_t v) {
+        return v % 3 == 0;
+    }));
+}
+
+// ---------------------------------------------------------------------------
+// 14. Lazy initialization: fresh slots come from the bump index in address
+//     order, recycled slots are preferred, and only handed-out slots can leak.
+// ---------------------------------------------------------------------------
+
+template <typename Pool>
+class LazyPoolTest : public ::testing::Test
+{
+};
+
+using LazyPools = ::testing::Types<BufferPool<Payload, 64, PoolStats>, LockFreeBufferPool<Payload, 64, PoolStats>>;
+TYPED_TEST_SUITE(LazyPoolTest, LazyPools);
+
+TYPED_TEST(LazyPoolTest, BumpThenRecycle)
+{
+    std::vector<std::size_t> leaked;
+
+    {
+        TypeParam pool{PoolInit::kLazy};
+
+        pool.stats().set_leak_handler([&](const PoolStatsSnapshot&, std::span<const std::size_t> slots) {
+            leaked.assign(slots.begin(), slots.end());
+        });
+
+        Payload* first  = pool.acquire();
+        Payload* second = pool.acquire();
+        ASSERT_NE(first, nullptr);
+        EXPECT_EQ(second, first + 1) << "fresh slots are bumped in address order";
+
+        pool.release(first);
+        EXPECT_EQ(pool.acquire(), first) << "a recycled slot is preferred over a fresh one";
+        EXPECT_EQ(pool.acquire(), second + 1);
+
+        std::vector<Payload*> rest;
+
+        while (Payload* p = pool.acquire()) {
+            rest.push_back(p);
+        }
+
+        EXPECT_EQ(rest.size(), 64U - 3U);
+        EXPECT_EQ(rest.back(), first + 63);
+        EXPECT_EQ(pool.stats().snapshot().exhaustions, 1U);
+
+        for (auto* p : rest) {
+            pool.release(p);
+        }
+
+        pool.release(second);
+    }
+
+    EXPECT_EQ(leaked, (std::vector<std::size_t>{0, 2})) << "slots never bumped must not be reported";
+}
+
+TEST(LazyPoolTest, LockFreeConcurrentUniqueness)
+{
+    constexpr std::size_t kPoolSize   = 256;
+    constexpr std::size_t kNumThreads = 8;
+    constexpr std::size_t kRounds     = 200;
+
+    LockFreeBufferPool<Payload, kPoolSize> pool{PoolInit::kLazy};
+
+    std::barrier sync_point(static_cast<std::ptrdiff_t>(kNumThreads));
+    std::atomic<bool> failed{false};
+
+    // Fresh slots hold garbage, so ownership is checked by stamping them first and verifying the stamps
+    // survived until release.
+    auto worker = [&](const uint64_t id) {
+        std::vector<Payload*> held;
+
+        sync_point.arrive_and_wait();
+
+        for (std::size_t round = 0; round < kRounds; ++round) {
+            for (std::size_t i = 0; i < kPoolSize / kNumThreads; ++i) {
+                Payload* p = pool.acquire();
+
+                if (p == nullptr) {
+                    failed = true;
+                    continue;
+                }
+
+                p->value = id;
+                held.push_back(p);
+            }
+
+            std::this_thread::yield();
+
+            for (auto* p : held) {
+                if (p->value != id) {
+                    failed = true;  // the slot was handed out twice
+                }
+
+                pool.release(p);
+            }
+
+            held.clear();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back(worker, t + 1);
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_FALSE(failed.load());
+}
+
+// ---------------------------------------------------------------------------
+// 15. ObjectPool: released objects are reset, not destroyed, so their heap
+//     buffers survive recycling; everything is destroyed with the pool.
+// ---------------------------------------------------------------------------
+
+struct Message
+{
+    Message()
+    {
+        ++alive;
+    }
+
+    Message(const Message&)            = delete;
+    Message& operator=(const Message&) = delete;
+
+    ~Message()
+    {
+        --alive;
+    }
+
+    void
+    reset() noexcept
+    {
+        text.clear();
+        values.clear();
+    }
+
+    std::string           text;
+    std::vector<uint64_t> values;
+
+    static inline int alive = 0;
+};
+
+TEST(ObjectPoolTest, RecyclingKeepsCapacity)
+{
+    {
+        ObjectPool<Message, 4> pool;
+
+        Message* message = pool.acquire();
+        ASSERT_NE(message, nullptr);
+
+        message->text.assign(200, 'x');
+        message->values.resize(64);
+
+        const auto* text   = message->text.data();
+        const auto* values = message->values.data();
+
+        pool.release(message);
+
+        Message* recycled = pool.acquire();
+        ASSERT_EQ(recycled, message);
+        EXPECT_TRUE(recycled->text.empty());
+        EXPECT_TRUE(recycled->values.empty());
+        EXPECT_GE(recycled->text.capacity(), 200U);
+        EXPECT_GE(recycled->values.capacity(), 64U);
+
+        recycled->text.assign(150, 'y');
+        recycled->values.resize(32);
+        EXPECT_EQ(recycled->text.data(), text) << "no reallocation after recycling";
+        EXPECT_EQ(recycled->values.data(), values);
+
+        pool.release(recycled);
+        EXPECT_EQ(pool.constructed(), 1U);
+        EXPECT_EQ(Message::alive, 1);
+    }
+
+    EXPECT_EQ(Message::alive, 0);
+}
+
+TEST(ObjectPoolTest, ExhaustionHandlesAndLeakReport)
+{
+    std::vector<std::size_t> leaked;
+
+    {
+        ObjectPool<Message, 3, PoolStats> pool;
+
+        pool.stats().set_leak_handler([&](const PoolStatsSnapshot&, std::span<const std::size_t> slots) {
+            leaked.assign(slots.begin(), slots.end());
+        });
+
+        Message* first = pool.acquire();
+
+        {
+            auto second = pool.make();
+            auto third  = pool.make();
+            ASSERT_TRUE(second && third);
+            EXPECT_FALSE(pool.make()) << "empty handle when all objects are in use";
+            EXPECT_EQ(Message::alive, 3);
+        }
+
+        EXPECT_EQ(Message::alive, 3) << "handles recycle, they do not destroy";
+        EXPECT_EQ(pool.stats().snapshot().inUse, 1U);
+
+        static_cast<void>(first);  // left out on purpose
+    }
+
+    EXPECT_EQ(leaked, (std::vector<std::size_t>{0}));
+    EXPECT_EQ(Message::alive, 0);
+}
+
+TEST(ObjectPoolTest, CustomResetHook)
+{
+    struct Reuse
+    {
+        void
+        operator()(std::string& text) const noexcept
+        {
+            text.clear();
+        }
+    };
+
+    ObjectPool<std::string, 2, NoPoolStats, Reuse> pool;
+
+    std::string* text = pool.acquire();
+    ASSERT_NE(text, nullptr);
+    text->assign(100, 'z');
+    pool.release(text);
+
+    std::string* reused = pool.acquire();
+    ASSERT_NE(reused, nullptr);
+    EXPECT_TRUE(reused->empty());
+    EXPECT_GE(text->capacity(), 100U);
+}
+
+// ---------------------------------------------------------------------------
+// 16. Arena: bump allocation, O(1) reset that keeps the blocks, oversized
+//     requests, pmr containers and one arena per thread.
+// ---------------------------------------------------------------------------
+
+TEST(ArenaTest, BumpAllocationAndAlignment)
+{
+    CountingResource upstream;
+    Arena            arena{4096, &upstream};
+
+    auto* a = static_cast<std::byte*>(arena.allocate(10, 1));
+    auto* b = static_cast<std::byte*>(arena.allocate(10, 1));
+    EXPECT_EQ(b, a + 10) << "consecutive requests are adjacent";
+
+    for (const std::size_t alignment : {2U, 8U, 16U, 64U, 256U}) {
+        void* p = arena.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % alignment, 0U) << alignment;
+    }
+
+    EXPECT_EQ(upstream.allocations, 1U);
+
+    for (int i = 0; i < 100; ++i) {
+        static_cast<void>(arena.allocate(100));
+    }
+
+    EXPECT_GT(upstream.allocations, 1U) << "a full block is followed by a new one";
+}
+
+TEST(ArenaTest, ResetKeepsBlocks)
+{
+    CountingResource upstream;
+
+    {
+        Arena arena{4096, &upstream};
+
+        auto fill = [&arena]() {
+            for (int i = 0; i < 200; ++i) {
+                static_cast<void>(arena.allocate(100));
+            }
+        };
+
+        fill();
+        const auto blocks = upstream.allocations;
+        const auto epoch  = arena.epoch();
+
+        for (int round = 0; round < 10; ++round) {
+            arena.reset();
+            fill();
+        }
+
+        EXPECT_EQ(upstream.allocations, blocks) << "later epochs reuse the blocks";
+        EXPECT_EQ(arena.epoch(), epoch + 10);
+
+        void* large = arena.allocate(64 * 1024);
+        EXPECT_NE(large, nullptr);
+        EXPECT_EQ(upstream.allocations, blocks + 1);
+
+        arena.reset();
+        EXPECT_EQ(upstream.deallocations, 1U) << "oversized blocks go back on reset";
+    }
+
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(ArenaTest, PmrContainersAndScope)
+{
+    CountingResource    upstream;
+    ArenaMemoryResource resource{16 * 1024, &upstream};
+
+    for (int event = 0; event < 5; ++event) {
+        const ArenaScope scope{resource};
+
+        std::pmr::vector<std::pmr::string>   strings{&resource};
+        std::pmr::map<int, std::pmr::string> lookup{&resource};
+
+        for (int i = 0; i < 20; ++i) {
+            strings.emplace_back(std::string(40, static_cast<char>('a' + i)));
+            lookup.emplace(i, strings.back());
+        }
+
+        EXPECT_EQ(std::string_view{lookup.at(7)}, std::string(40, 'h'));
+    }
+
+    EXPECT_EQ(resource.arena().epoch(), 5U);
+    EXPECT_LE(upstream.allocations, 2U) << "every event after the first runs on the kept blocks";
+}
+
+TEST(ArenaTest, ThreadLocalArenas)
+{
+    ArenaMemoryResource* main  = &threadArena();
+    ArenaMemoryResource* other = nullptr;
+
+    std::thread worker{[&other]() {
+        other = &threadArena();
+
+        std::pmr::vector<int> values{other};
+        values.resize(1000);
+        other->reset();
+    }};
+    worker.join();
+
+    EXPECT_EQ(main, &threadArena());
+    EXPECT_NE(main, other);
+}
+
 }  // namespace
@@ -1,10 +1,21 @@
+#include "example02/chaselevdeque.hpp"
+#include "example02/coroutine.hpp"
 #include "example02/executor.hpp"
+#include "example02/timerwheel.hpp"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <csignal>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <ranges>
+#include <stop_token>
+#include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -72,6 +83,243 @@ TEST_F(ExecutorTest, postWithFutureVoidTest)
     ASSERT_NO_THROW(f.get());
 }
 
+TEST_F(ExecutorTest, submitThenTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    // every step runs as a task of the executor, nothing blocks until the final get()
+    auto f = executor.submit(500ms, []() -> int {
+                         return 20;
+                     })
+                 .then([](int value) {
+                     return value + 1;
+                 })
+                 .then([](int value) {
+                     return std::to_string(value * 2);
+                 });
+
+    auto v = executor.submit([]() {
+                     })
+                 .then([]() -> int {
+                     return 7;
+                 });
+
+    auto failed = executor.submit([]() -> int {
+                              throw std::runtime_error("");
+                          })
+                      .then([this](int value) {
+                          this->tick();
+                          return value;
+                      });
+
+    EXPECT_CALL(*this, tick()).Times(0);
+
+    ASSERT_NO_THROW(executor.run(2U));
+
+    ASSERT_TRUE(f.is_ready());
+    EXPECT_EQ(f.get(), "42");
+    EXPECT_FALSE(f.valid());
+    EXPECT_EQ(v.get(), 7);
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    Future<int> broken;
+    {
+        Promise<int> promise{executor};
+        broken = promise.get_future();
+    }
+    EXPECT_THROW(broken.get(), std::future_error);
+}
+
+TEST_F(ExecutorTest, whenAllWhenAnyTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    std::atomic<bool> release{false};
+
+    auto all = when_all(executor.submit([]() -> int {
+                            return 1;
+                        }),
+                        executor.submit([]() {
+                        }),
+                        executor.submit([]() -> std::string {
+                            return "two";
+                        }));
+
+    std::vector<Future<size_t>> futures;
+
+    for (size_t i{0U}; i < 8U; ++i) {
+        futures.push_back(executor.submit([i]() {
+            return i * i;
+        }));
+    }
+
+    auto squares = when_all(executor, std::move(futures)).then([](std::vector<size_t> values) {
+        return std::accumulate(values.begin(), values.end(), size_t{0U});
+    });
+
+    // the slow one is still spinning when the fast one wins
+    std::vector<Future<int>> racers;
+    racers.push_back(executor.submit([&release]() -> int {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        return 1;
+    }));
+    racers.push_back(executor.submit([]() -> int {
+        return 2;
+    }));
+
+    auto any = when_any(executor, std::move(racers)).then([&release](WhenAnyResult<int> result) {
+        release.store(true);
+        return result;
+    });
+
+    std::vector<Future<int>> failing;
+    failing.push_back(executor.submit([]() -> int {
+        return 1;
+    }));
+    failing.push_back(executor.submit([]() -> int {
+        throw std::runtime_error("");
+    }));
+
+    auto failed = when_all(executor, std::move(failing));
+
+    ASSERT_NO_THROW(executor.run(2U));
+
+    EXPECT_EQ(all.get(), std::make_tuple(1, Unit{}, std::string{"two"}));
+    EXPECT_EQ(squares.get(), 140U);
+
+    const auto winner = any.get();
+    EXPECT_EQ(winner.index, 1U);
+    EXPECT_EQ(winner.value, 2);
+
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+namespace
+{
+Task<int>
+delayedValue(Executor& executor, const int value, const Executor::Duration delay = 5ms)
+{
+    co_await executor.sleep_for(delay);
+
+    co_return value;
+}
+
+Task<void>
+failing(Executor& executor)
+{
+    co_await executor.schedule();
+
+    throw std::runtime_error("");
+}
+
+Task<std::string>
+pipeline(Executor& executor, std::atomic<size_t>& steps)
+{
+    int sum = 0;
+
+    for (int i{0}; i < 4; ++i) {
+        sum += co_await delayedValue(executor, i);
+        steps.fetch_add(1U);
+    }
+
+    co_await executor.schedule(Executor::Priority::kBackground);
+
+    co_return std::to_string(sum);
+}
+
+Task<int>
+sleeping(Executor& executor, const std::shared_ptr<int> held)
+{
+    co_await executor.sleep_for(1h);
+
+    co_return *held;
+}
+
+Task<int>
+stopping(Executor& executor, const std::shared_ptr<int> held)
+{
+    executor.stop();
+    co_await executor.schedule();
+
+    co_return *held;
+}
+}  // namespace
+
+TEST_F(ExecutorTest, coroutineTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    std::atomic<size_t> steps{0U};
+
+    auto result = co_spawn(executor, pipeline(executor, steps));
+    auto timed  = co_spawn(executor, 1s, delayedValue(executor, 42));
+    auto failed = co_spawn(executor, failing(executor));
+
+    // never started: the frames are freed with the task
+    {
+        auto unused = delayedValue(executor, 0);
+    }
+
+    ASSERT_NO_THROW(executor.run(2U));
+
+    EXPECT_EQ(result.get(), "6");
+    EXPECT_EQ(steps.load(), 4U);
+    EXPECT_EQ(timed.get(), 42);
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST_F(ExecutorTest, coroutineTimeoutTest)
+{
+    Executor executor;
+
+    std::atomic<bool> timedOut{false};
+
+    // the interval covers the whole coroutine, suspensions included
+    auto late = co_spawn(executor, 20ms, delayedValue(executor, 1, 200ms));
+
+    executor.startWatchdogTask(10ms, [&executor, &timedOut](bool status) {
+        if (!status) {
+            timedOut.store(true);
+            executor.stop();
+        }
+    });
+
+    ASSERT_NO_THROW(executor.run(1U));
+    executor.stopWatchdogTask();
+
+    EXPECT_TRUE(timedOut.load());
+    EXPECT_FALSE(late.is_ready());
+
+    // the coroutine is still sleeping and completes on the next run
+    executor.restart();
+    ASSERT_NO_THROW(executor.run(1U));
+
+    EXPECT_EQ(late.get(), 1);
+}
+
+TEST_F(ExecutorTest, coroutineFreedWithExecutorTest)
+{
+    auto               alive = std::make_shared<int>(0);
+    std::weak_ptr<int> watched{alive};
+
+    {
+        Executor executor;
+
+        // one waits on a timer, the other is queued behind the stop when run() returns
+        auto slept   = co_spawn(executor, 1h, sleeping(executor, alive));
+        auto stopped = co_spawn(executor, stopping(executor, std::move(alive)));
+
+        ASSERT_NO_THROW(executor.run(1U));
+        EXPECT_FALSE(slept.is_ready());
+        EXPECT_FALSE(stopped.is_ready());
+    }
+
+    // the discarded handlers freed the frames they would have resumed
+    EXPECT_TRUE(watched.expired());
+}
+
 TEST_F(ExecutorTest, createPeriodicTaskTest)
 {
     constexpr size_t kCallCount = 10U;
@@ -342,4 +590,1079 @@ TEST_F(ExecutorTest, watchdogTaskTest)
     task->stop();
 }
 
+TEST(ChaseLevDequeTest, everyItemTakenExactlyOnce)
+{
+    constexpr size_t kItems   = 100'000U;
+    constexpr size_t kThieves = 3U;
+
+    ChaseLevDeque<size_t> deque{8U};  // small, so the owner has to grow it while thieves are active
+
+    std::vector<std::atomic<uint32_t>> taken(kItems);
+    std::atomic<bool>                  done{false};
+
+    std::vector<std::thread> thieves;
+
+    for (size_t t{0U}; t < kThieves; ++t) {
+        thieves.emplace_back([&]() {
+            size_t item = 0U;
+
+            while (!done.load() || !deque.empty()) {
+                if (deque.steal(item)) {
+                    taken[item].fetch_add(1U);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    size_t item = 0U;
+
+    for (size_t i{0U}; i < kItems; ++i) {
+        deque.push(i);
+
+        if (i % 3U == 0U && deque.pop(item)) {
+            taken[item].fetch_add(1U);
+        }
+    }
+
+    while (deque.pop(item)) {
+        taken[item].fetch_add(1U);
+    }
+
+    done.store(true);
+
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(taken, [](const auto& count) {
+        return count.load() == 1U;
+    }));
+}
+
+TEST_F(ExecutorTest, workStealingSpawnTest)
+{
+    constexpr size_t kExternal = 1'000U;
+    constexpr size_t kChildren = 10U;
+
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    std::atomic<size_t> count{0U};
+
+    // external posts go through the injection queue, nested ones through the worker deques
+    for (size_t i{0U}; i < kExternal; ++i) {
+        executor.spawn([&executor, &count]() {
+            count.fetch_add(1U);
+
+            if (count.load() % 100U == 0U) {
+                for (size_t c{0U}; c < kChildren; ++c) {
+                    executor.spawn(500ms, [&count]() {
+                        count.fetch_add(1U);
+                    });
+                }
+            }
+        });
+    }
+
+    ASSERT_NO_THROW(executor.run(4U));
+
+    EXPECT_GE(count.load(), kExternal);
+    EXPECT_EQ((count.load() - kExternal) % kChildren, 0U);
+    EXPECT_TRUE(executor.stopped());
+}
+
+TEST_F(ExecutorTest, workStealingOverflowOrderTest)
+{
+    constexpr size_t kTasks = 200U;
+
+    // far more external posts than the injection queue holds: the overflowed ones run after it, oldest first
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing, .injectionQueueCapacity = 4U}};
+
+    std::vector<size_t> order;
+
+    for (size_t i{0U}; i < kTasks; ++i) {
+        executor.spawn([&order, i]() {
+            order.push_back(i);
+        });
+    }
+
+    executor.spawnBatch(std::views::iota(kTasks, 2U * kTasks) | std::views::transform([&order](const size_t i) {
+                            return [&order, i]() {
+                                order.push_back(i);
+                            };
+                        }));
+
+    // one worker thread
+    ASSERT_NO_THROW(executor.run(1U));
+
+    ASSERT_EQ(order.size(), 2U * kTasks);
+    EXPECT_TRUE(std::ranges::is_sorted(order));
+}
+
+TEST_F(ExecutorTest, workStealingPostAndExceptionTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    auto f = executor.post(500ms, []() -> int {
+        const int result = 42;
+        return result;
+    });
+
+    ASSERT_NO_THROW(executor.run(2U));
+    ASSERT_EQ(f.get(), 42);
+
+    executor.restart();
+
+    executor.spawn(500ms, []() {
+        throw std::runtime_error("");
+    });
+
+    ASSERT_THROW(executor.run(2U), std::runtime_error);
+}
+
+TEST_F(ExecutorTest, workStealingRestartTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    ASSERT_NO_THROW(executor.run());
+
+    size_t count = 0U;
+
+    executor.spawn(500ms, [&count]() {
+        count++;
+    });
+
+    ASSERT_NO_THROW(executor.run());
+    ASSERT_EQ(count, 0U);  // executor is stopped after run() call
+
+    executor.restart();
+
+    ASSERT_NO_THROW(executor.run());  // executor run queued task after restart
+    ASSERT_EQ(count, 1U);
+}
+
+TEST_F(ExecutorTest, workStealingPeriodicTaskTest)
+{
+    constexpr size_t kCallCount = 5U;
+
+    EXPECT_CALL(*this, tick()).Times(static_cast<int>(kCallCount));
+
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    size_t count = 0U;
+
+    std::shared_ptr<Executor::PeriodicTask> task = executor.createPeriodicTask(5ms, [&task, &count, this]() {
+        this->tick();
+
+        if (++count == kCallCount) {
+            task->stop();
+        }
+    });
+
+    task->start();
+
+    ASSERT_NO_THROW(executor.run(2U));
+}
+
+TEST_F(ExecutorTest, periodicScheduleTest)
+{
+    constexpr auto   kPeriod  = 30ms;
+    constexpr auto   kOverrun = 100ms;  // the deadlines at 60, 90 and 120 ms pass during the second run
+    constexpr auto   kSlack   = 10ms;
+    constexpr size_t kRuns    = 6U;
+
+    struct Case
+    {
+        Executor::PeriodicSchedule schedule;
+        size_t                     immediate;  // runs right after the long one
+    };
+
+    for (const auto timer : {Executor::PeriodicTimer::kSteadyTimer, Executor::PeriodicTimer::kTimerWheel}) {
+        for (const auto [schedule, immediate] : {Case{Executor::PeriodicSchedule::kSkip, 0U},
+                                                 Case{Executor::PeriodicSchedule::kCatchUp, 2U},
+                                                 Case{Executor::PeriodicSchedule::kCoalesce, 1U}}) {
+            Executor executor{Executor::Options{.periodicTimer    = timer,
+                                                .periodicSchedule = schedule,
+                                                .periodicBurst    = 2U}};
+
+            std::vector<Executor::TimePoint> starts;
+            Executor::TimePoint              overrunEnd;
+
+            std::shared_ptr<Executor::PeriodicTask> task = executor.createPeriodicTask(kPeriod, [&]() {
+                starts.push_back(Executor::Clock::now());
+
+                if (starts.size() == 2U) {
+                    std::this_thread::sleep_for(kOverrun);
+                    overrunEnd = Executor::Clock::now();
+                }
+
+                if (starts.size() == kRuns) {
+                    task->stop();
+                }
+            });
+
+            task->start();
+
+            ASSERT_NO_THROW(executor.run());
+            ASSERT_EQ(starts.size(), kRuns);
+
+            size_t index = 2U;
+
+            for (; index < kRuns && starts[index] - overrunEnd < kSlack; ++index) {
+            }
+
+            EXPECT_EQ(index - 2U, immediate);
+
+            // after that the task is back in phase with its first run: at 150, 180, ... ms
+            for (; index < kRuns; ++index) {
+                const auto offset = (starts[index] - starts[0]) % kPeriod;
+
+                EXPECT_TRUE(offset < kSlack || offset > kPeriod - kSlack)
+                    << "run " << index << " is " << std::chrono::duration_cast<std::chrono::microseconds>(offset).count()
+                    << " us off phase";
+            }
+        }
+    }
+}
+
+TEST_F(ExecutorTest, highResolutionPeriodicTaskTest)
+{
+    constexpr size_t kRuns = 200U;
+
+    Executor executor{Executor::Options{.metrics = true}};
+
+    size_t runs = 0U;
+
+    std::shared_ptr<Executor::PeriodicTask> task = executor.createPeriodicTask(
+        500us,
+        [&task, &runs]() {
+            if (++runs == kRuns) {
+                task->stop();
+            }
+        },
+        Executor::HighResolution{.spinMargin = 200us});
+
+    task->start();
+
+    // returns once the task has stopped
+    ASSERT_NO_THROW(executor.run());
+
+    const auto metrics = executor.metrics();
+
+    EXPECT_EQ(runs, kRuns);
+    EXPECT_EQ(metrics.periodicRuns, kRuns);
+    EXPECT_LT(metrics.periodicDeviation.percentile(0.5), 50us);
+
+    // an exception of func comes out of run(), as from any other task
+    auto failing = executor.createPeriodicTask(
+        1ms,
+        []() {
+            throw std::runtime_error("");
+        },
+        Executor::HighResolution{});
+
+    executor.restart();
+    failing->start();
+
+    ASSERT_THROW(executor.run(), std::runtime_error);
+}
+
+TEST_F(ExecutorTest, shardedSpawnTest)
+{
+    constexpr size_t kShards = 3U;
+    constexpr size_t kTasks  = 300U;
+
+    Executor executor{Executor::Options{.backend = Executor::Backend::kSharded, .shardsCount = kShards}};
+
+    ASSERT_EQ(executor.shardsCount(), kShards);
+
+    std::mutex                                        mutex;
+    std::array<std::vector<std::thread::id>, kShards> seen;
+    std::atomic<size_t>                               count{0U};
+
+    // every task of a shard runs on that shard's thread, including the ones spawned from another shard
+    for (size_t i{0U}; i < kTasks; ++i) {
+        executor.spawnOn(i, [&, i]() {
+            {
+                const std::lock_guard<std::mutex> lock{mutex};
+                seen[i % kShards].push_back(std::this_thread::get_id());
+            }
+
+            count.fetch_add(1U);
+
+            if (i % 10U == 0U) {
+                executor.spawnOn(i + 1U, [&, i]() {
+                    const std::lock_guard<std::mutex> lock{mutex};
+                    seen[(i + 1U) % kShards].push_back(std::this_thread::get_id());
+                });
+            }
+        });
+    }
+
+    auto f = executor.post(500ms, []() -> int {
+        return 42;
+    });
+
+    ASSERT_NO_THROW(executor.run());
+    ASSERT_EQ(f.get(), 42);
+    EXPECT_EQ(count.load(), kTasks);
+    EXPECT_TRUE(executor.stopped());
+
+    for (const auto& ids : seen) {
+        ASSERT_FALSE(ids.empty());
+        EXPECT_TRUE(std::ranges::all_of(ids, [&ids](const auto& id) {
+            return id == ids.front();
+        }));
+    }
+
+    EXPECT_EQ(seen[0].front(), std::this_thread::get_id());
+    EXPECT_NE(seen[1].front(), seen[2].front());
+
+    executor.restart();
+
+    executor.spawnOn(2U, []() {
+        throw std::runtime_error("");
+    });
+
+    ASSERT_THROW(executor.run(), std::runtime_error);
+}
+
+TEST_F(ExecutorTest, shardedPeriodicTaskTest)
+{
+    constexpr size_t kCallCount = 5U;
+
+    EXPECT_CALL(*this, tick()).Times(static_cast<int>(kCallCount));
+
+    Executor executor{Executor::Options{.backend = Executor::Backend::kSharded, .shardsCount = 2U}};
+
+    size_t          count = 0U;
+    std::thread::id owner;
+
+    // pinned to the other shard: run() must keep going until the task stops itself
+    std::shared_ptr<Executor::PeriodicTask> task = executor.createPeriodicTaskOn(1U, 5ms, [&, this]() {
+        this->tick();
+
+        if (count++ == 0U) {
+            owner = std::this_thread::get_id();
+        }
+
+        EXPECT_EQ(owner, std::this_thread::get_id());
+        EXPECT_NE(owner, std::thread::id{});
+
+        if (count == kCallCount) {
+            task->stop();
+        }
+    });
+
+    task->start();
+
+    ASSERT_NO_THROW(executor.run());
+    EXPECT_EQ(count, kCallCount);
+}
+
+TEST_F(ExecutorTest, runConfigTest)
+{
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+    const Executor::RunConfig config{
+        .threadsCount = 1U,
+        .threads      = {ThreadConfig{.name = "ws-worker-with-a-long-name", .cpus = {0}, .fifoPriority = 1}},
+        .stackSize    = 256U * 1024U,
+    };
+
+    std::thread::id worker;
+
+    // with the work-stealing backend every task runs on a worker thread
+    const auto check = [&worker]() {
+        std::array<char, 16> name{};
+        pthread_getname_np(pthread_self(), name.data(), name.size());
+
+        EXPECT_STREQ(name.data(), "ws-worker-with-");
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus), 0);
+        EXPECT_EQ(CPU_COUNT(&cpus), 1);
+        EXPECT_TRUE(CPU_ISSET(0, &cpus));
+
+        worker = std::this_thread::get_id();
+    };
+
+    executor.spawn(check);
+
+    ASSERT_NO_THROW(executor.run(config));
+    ASSERT_NE(worker, std::thread::id{});
+
+    const auto first = worker;
+
+    executor.restart();
+    executor.spawn(check);
+
+    ASSERT_NO_THROW(executor.run(config));
+    EXPECT_EQ(worker, first);  // the thread is reused across restart()
+
+    // a later run with the default config leaves no pinning and no name of the earlier ones behind
+    cpu_set_t inherited;
+    CPU_ZERO(&inherited);
+    ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(inherited), &inherited), 0);
+
+    executor.restart();
+    executor.spawn([&worker, &inherited]() {
+        std::array<char, 16> name{};
+        pthread_getname_np(pthread_self(), name.data(), name.size());
+
+        EXPECT_STREQ(name.data(), "executor-0");
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus), 0);
+        EXPECT_TRUE(CPU_EQUAL(&cpus, &inherited));
+
+        worker = std::this_thread::get_id();
+    });
+
+    ASSERT_NO_THROW(executor.run(Executor::RunConfig{.threadsCount = 1U, .threads = {}, .stackSize = 256U * 1024U}));
+    EXPECT_EQ(worker, first);
+}
+
+TEST_F(ExecutorTest, priorityLanesTest)
+{
+    using Priority = Executor::Priority;
+
+    // one drainer on one thread: the order the tasks run in is exactly the order the lanes hand them out
+    Executor executor{Executor::Options{.priorityLanes = true, .laneDrainers = 1U, .laneWeights = {2U, 1U, 1U}}};
+
+    std::vector<Priority> order;
+
+    for (size_t i{0U}; i < 12U; ++i) {
+        executor.spawn(Priority::kBackground, [&order]() {
+            order.push_back(Priority::kBackground);
+        });
+    }
+
+    for (size_t i{0U}; i < 12U; ++i) {
+        executor.spawn(Priority::kCritical, 500ms, [&order]() {
+            order.push_back(Priority::kCritical);
+        });
+    }
+
+    auto f = executor.post(Priority::kNormal, 500ms, [&order]() -> int {
+        order.push_back(Priority::kNormal);
+        return 42;
+    });
+
+    ASSERT_NO_THROW(executor.run());
+    ASSERT_EQ(f.get(), 42);
+    ASSERT_EQ(order.size(), 25U);
+
+    // rounds of four turns: critical, critical, normal (or the highest non-empty lane), background
+    EXPECT_EQ(order[0], Priority::kCritical);
+    EXPECT_EQ(order[1], Priority::kCritical);
+    EXPECT_EQ(order[2], Priority::kNormal);
+    EXPECT_EQ(order[3], Priority::kBackground);
+    EXPECT_EQ(order[6], Priority::kCritical);
+    EXPECT_EQ(order[7], Priority::kBackground);
+
+    // the background lane is not starved while critical tasks are queued
+    const auto firstCritical = std::ranges::count(order.begin(), order.begin() + 12, Priority::kCritical);
+    EXPECT_LT(firstCritical, 12);
+    EXPECT_EQ(order.back(), Priority::kBackground);
+
+    executor.restart();
+
+    // a background periodic task runs in its lane, behind a flood of background tasks that the critical one skips
+    std::atomic<size_t> criticalRuns{0U};
+    std::atomic<size_t> backgroundRuns{0U};
+
+    std::shared_ptr<Executor::PeriodicTask> critical;
+    std::shared_ptr<Executor::PeriodicTask> background;
+
+    critical = executor.createPeriodicTask(
+        10ms,
+        [&]() {
+            if (criticalRuns.fetch_add(1U) + 1U >= 5U && backgroundRuns.load() > 0U) {
+                critical->stop();
+                background->stop();
+            }
+        },
+        false);
+
+    background = executor.createPeriodicTask(
+        10ms,
+        [&backgroundRuns]() {
+            backgroundRuns.fetch_add(1U);
+        },
+        false,
+        Priority::kBackground);
+
+    for (size_t i{0U}; i < 200U; ++i) {
+        executor.spawn(Priority::kBackground, []() {
+            std::this_thread::sleep_for(100us);
+        });
+    }
+
+    critical->start();
+    background->start();
+
+    ASSERT_NO_THROW(executor.run(1U));
+
+    EXPECT_GE(criticalRuns.load(), 5U);
+    EXPECT_GE(backgroundRuns.load(), 1U);
+}
+
+TEST_F(ExecutorTest, priorityLanesOverflowOrderTest)
+{
+    constexpr size_t kTasks = 50U;
+
+    // a lane of four slots: tasks queued while it has overflowed, nested ones included, wait behind the overflow
+    Executor executor{Executor::Options{.injectionQueueCapacity = 4U, .priorityLanes = true, .laneDrainers = 1U}};
+
+    std::vector<size_t> order;
+
+    for (size_t i{0U}; i < kTasks; ++i) {
+        executor.spawn([&executor, &order, i]() {
+            order.push_back(i);
+
+            if (i == 0U) {
+                for (size_t nested{kTasks}; nested < 2U * kTasks; ++nested) {
+                    executor.spawn([&order, nested]() {
+                        order.push_back(nested);
+                    });
+                }
+            }
+        });
+    }
+
+    ASSERT_NO_THROW(executor.run());
+
+    ASSERT_EQ(order.size(), 2U * kTasks);
+    EXPECT_TRUE(std::ranges::is_sorted(order));
+}
+
+TEST_F(ExecutorTest, batchSliceTest)
+{
+    constexpr size_t kTasks = 40U;
+
+    const std::array options{
+        Executor::Options{.backend = Executor::Backend::kAsio},
+        Executor::Options{.backend = Executor::Backend::kSharded, .shardsCount = 3U},
+        Executor::Options{.injectionQueueCapacity = 4U, .priorityLanes = true, .laneDrainers = 2U},
+    };
+
+    for (const auto& option : options) {
+        Executor executor{option};
+
+        // a task that throws, or one that stops the executor, leaves the rest of its slice queued for the next run
+        for (const bool throwing : {true, false}) {
+            std::vector<std::atomic<size_t>> runs(kTasks);
+
+            executor.spawnBatch(std::views::iota(size_t{0U}, kTasks) | std::views::transform([&](const size_t i) {
+                                    return [&executor, &runs, throwing, i]() {
+                                        runs[i].fetch_add(1U);
+
+                                        if (i == kTasks / 2U) {
+                                            executor.stop();
+
+                                            if (throwing) {
+                                                throw std::runtime_error("");
+                                            }
+                                        }
+                                    };
+                                }));
+
+            if (throwing) {
+                EXPECT_THROW(executor.run(2U), std::runtime_error);
+            }
+            else {
+                ASSERT_NO_THROW(executor.run(2U));
+            }
+
+            executor.restart();
+            ASSERT_NO_THROW(executor.run(2U));
+            executor.restart();
+
+            EXPECT_TRUE(std::ranges::all_of(runs, [](const auto& count) {
+                return count.load() == 1U;
+            }));
+        }
+    }
+}
+
+TEST_F(ExecutorTest, batchTest)
+{
+    constexpr size_t kTasks = 500U;
+
+    const std::array options{
+        Executor::Options{.backend = Executor::Backend::kAsio},
+        Executor::Options{.backend = Executor::Backend::kWorkStealing, .injectionQueueCapacity = 64U},
+        Executor::Options{.backend = Executor::Backend::kSharded, .shardsCount = 3U},
+        Executor::Options{.backend = Executor::Backend::kWorkStealing, .priorityLanes = true},
+    };
+
+    for (const auto& option : options) {
+        Executor executor{option};
+
+        std::atomic<size_t> sum{0U};
+        std::atomic<size_t> nested{0U};
+
+        const auto add = [&sum](const size_t i) {
+            return [&sum, i]() {
+                sum.fetch_add(i);
+            };
+        };
+
+        executor.spawnBatch(std::views::iota(size_t{0U}, kTasks) | std::views::transform(add));
+
+        // from inside a task, and from an lvalue range, which is copied from
+        std::vector<std::function<void()>> funcs(kTasks, [&nested]() {
+            nested.fetch_add(1U);
+        });
+
+        executor.spawn([&]() {
+            executor.spawnBatch(Executor::Priority::kBackground, 1s, funcs);
+        });
+
+        auto done = executor.postBatch(1s, std::views::iota(size_t{0U}, kTasks) | std::views::transform(add));
+
+        auto failed = executor.postBatch(1s, std::array{std::function<void()>{[]() {
+                                                        }},
+                                                        std::function<void()>{[]() {
+                                                            throw std::runtime_error("");
+                                                        }}});
+
+        auto empty = executor.postBatch(1s, std::vector<std::function<void()>>{});
+
+        ASSERT_NO_THROW(executor.run(2U));
+
+        EXPECT_EQ(sum.load(), kTasks * (kTasks - 1U));
+        EXPECT_EQ(nested.load(), kTasks);
+        EXPECT_TRUE(std::ranges::all_of(funcs, [](const auto& func) {
+            return static_cast<bool>(func);
+        }));
+        EXPECT_NO_THROW(done.get());
+        EXPECT_THROW(failed.get(), std::runtime_error);
+        EXPECT_NO_THROW(empty.get());
+    }
+}
+
+TEST_F(ExecutorTest, metricsTest)
+{
+    constexpr size_t kTasks = 20U;
+
+    Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing, .metrics = true}};
+
+    for (size_t i{0U}; i < kTasks; ++i) {
+        executor.spawn([]() {
+            std::this_thread::sleep_for(1ms);
+        });
+    }
+
+    auto posted = executor.post(1s, []() -> int {
+        return 1;
+    });
+
+    executor.spawnBatch(std::vector<std::function<void()>>(2U, []() {
+                        }));
+
+    // scraped from a periodic task, which overruns its period once
+    MetricsSnapshot scraped;
+    size_t          runs = 0U;
+
+    std::shared_ptr<Executor::PeriodicTask> task = executor.createPeriodicTask(5ms, [&]() {
+        if (++runs == 2U) {
+            std::this_thread::sleep_for(10ms);
+        }
+
+        if (runs == 4U) {
+            scraped = executor.metrics();
+            task->stop();
+        }
+    });
+
+    task->start();
+
+    ASSERT_NO_THROW(executor.run(2U));
+    EXPECT_EQ(posted.get(), 1);
+
+    const auto metrics = executor.metrics();
+
+    EXPECT_EQ(metrics.submitted, kTasks + 3U);
+    EXPECT_EQ(metrics.completed, kTasks + 3U);
+    EXPECT_EQ(metrics.inFlight, 0U);
+    EXPECT_EQ(metrics.queueWait.count, kTasks + 3U);
+    EXPECT_EQ(metrics.runTime.count, kTasks + 3U);
+    EXPECT_GE(metrics.runTime.max, 1ms);
+    EXPECT_GE(metrics.runTime.percentile(0.9), 1ms);
+    EXPECT_EQ(metrics.periodicRuns, 4U);
+    EXPECT_EQ(metrics.periodicDeviation.count, 4U);
+    EXPECT_EQ(metrics.periodicOverruns, 1U);
+    EXPECT_EQ(scraped.periodicRuns, 4U);
+    EXPECT_EQ(scraped.periodicOverruns, 1U);
+
+    // without Options::metrics nothing is recorded
+    Executor plain;
+    plain.spawn([]() {
+    });
+    ASSERT_NO_THROW(plain.run());
+    EXPECT_EQ(plain.metrics().submitted, 0U);
+}
+
+TEST_F(ExecutorTest, deadlineTest)
+{
+    // a task taking a stop token is asked to stop at its deadline; the caller's thread runs the timers meanwhile
+    {
+        Executor executor{Executor::Options{.backend = Executor::Backend::kWorkStealing}};
+
+        auto cancelled = executor.submit(20ms, [](const std::stop_token& token) -> bool {
+            const auto giveUp = std::chrono::steady_clock::now() + 5s;
+
+            while (!token.stop_requested() && std::chrono::steady_clock::now() < giveUp) {
+                std::this_thread::sleep_for(1ms);
+            }
+
+            return token.stop_requested();
+        });
+
+        auto inTime = executor.post(1s, [](const std::stop_token& token) -> int {
+            return token.stop_requested() ? 0 : 42;
+        });
+
+        bool stoppable = true;
+        executor.spawn([&stoppable](const std::stop_token& token) {
+            stoppable = token.stop_possible();
+        });
+
+        ASSERT_NO_THROW(executor.run(1U));
+        EXPECT_TRUE(cancelled.get());
+        EXPECT_EQ(inTime.get(), 42);
+        EXPECT_FALSE(stoppable);
+    }
+
+    // with dropExpired, tasks still queued past their deadline do not run
+    {
+        Executor executor{Executor::Options{.metrics = true, .dropExpired = true}};
+
+        std::atomic<size_t> runs{0U};
+
+        const auto count = [&runs]() {
+            runs.fetch_add(1U);
+        };
+
+        executor.spawn([]() {
+            std::this_thread::sleep_for(20ms);
+        });
+
+        executor.spawn(5ms, count);
+        auto posted    = executor.post(5ms, count);
+        auto submitted = executor.submit(5ms, count);
+        auto batch     = executor.postBatch(5ms, std::vector<std::function<void()>>(2U, count));
+        auto inTime    = executor.post(1s, count);
+
+        ASSERT_NO_THROW(executor.run());
+        EXPECT_THROW(posted.get(), DeadlineExceeded);
+        EXPECT_THROW(submitted.get(), DeadlineExceeded);
+        EXPECT_THROW(batch.get(), DeadlineExceeded);
+        EXPECT_NO_THROW(inTime.get());
+        EXPECT_EQ(runs.load(), 1U);
+        EXPECT_EQ(executor.metrics().expired, 5U);
+        EXPECT_EQ(executor.metrics().completed, 7U);
+    }
+
+    // earliest deadline first: one drainer on one thread runs the tasks with a timeout in deadline order, the
+    // tasks without one in queue order
+    {
+        Executor executor{Executor::Options{.laneDrainers = 1U, .earliestDeadlineFirst = true}};
+
+        std::vector<int> order;
+
+        for (const int timeout : {50, 10, 30, 20, 40}) {
+            executor.spawn(std::chrono::milliseconds{timeout}, [&order, timeout]() {
+                order.push_back(timeout);
+            });
+        }
+
+        auto first = executor.post(5ms, [&order]() {
+            order.push_back(5);
+        });
+
+        executor.spawnBatch(1s, std::vector<std::function<void()>>(2U, [&order]() {
+                                order.push_back(1000);
+                            }));
+
+        ASSERT_NO_THROW(executor.run());
+        EXPECT_NO_THROW(first.get());
+        EXPECT_THAT(order, testing::ElementsAre(5, 10, 20, 30, 40, 50, 1000, 1000));
+    }
+}
+
+TEST(TimerWheelTest, firesInOrderAcrossLevels)
+{
+    constexpr auto kTick = 50us;
+
+    struct Entry
+    {
+        TimerWheel::Duration  delay;
+        TimerWheel::TimePoint due;
+        TimerWheel::TimePoint fired;
+        std::vector<size_t>*  order;
+        size_t                index;
+    };
+
+    asio::io_context ioContext;
+    TimerWheel       wheel{ioContext, kTick};
+
+    // level 0, level 1 (>= 64 ticks), level 2 (>= 4096 ticks) and one that is cancelled
+    std::vector<size_t>                             order;
+    std::array<Entry, 5>                            entries{{{0ms, {}, {}, &order, 0U},
+                                                             {1ms, {}, {}, &order, 1U},
+                                                             {20ms, {}, {}, &order, 2U},
+                                                             {300ms, {}, {}, &order, 3U},
+                                                             {10ms, {}, {}, &order, 4U}}};
+    std::vector<std::unique_ptr<TimerWheel::Timer>> timers;
+
+    for (auto& entry : entries) {
+        timers.push_back(std::make_unique<TimerWheel::Timer>(
+            [](void* context, bool fired) {
+                auto* e = static_cast<Entry*>(context);
+
+                if (fired) {
+                    e->fired = TimerWheel::Clock::now();
+                    e->order->push_back(e->index);
+                }
+            },
+            &entry));
+    }
+
+    asio::dispatch(wheel.executor(), [&]() {
+        for (size_t i{0U}; i < entries.size(); ++i) {
+            entries[i].due = TimerWheel::Clock::now() + entries[i].delay;
+            wheel.schedule(*timers[i], entries[i].delay);
+        }
+
+        wheel.cancel(*timers[4]);
+
+        EXPECT_EQ(wheel.size(), 4U);
+    });
+
+    ioContext.run();  // returns once the wheel is empty
+
+    EXPECT_EQ(order, (std::vector<size_t>{0U, 1U, 2U, 3U}));
+    EXPECT_EQ(wheel.size(), 0U);
+
+    for (size_t i{0U}; i < 4U; ++i) {
+        EXPECT_GE(entries[i].fired, entries[i].due) << i;
+        EXPECT_FALSE(timers[i]->scheduled());
+    }
+}
+
+TEST_F(ExecutorTest, timerWheelPeriodicTasksTest)
+{
+    constexpr size_t kTasks     = 1'000U;
+    constexpr size_t kCallCount = 3U;
+
+    for (const auto backend : {Executor::Backend::kAsio, Executor::Backend::kSharded}) {
+        Executor executor{Executor::Options{.backend        = backend,
+                                            .shardsCount    = 2U,
+                                            .periodicTimer  = Executor::PeriodicTimer::kTimerWheel,
+                                            .timerWheelTick = 1ms}};
+
+        std::vector<std::shared_ptr<Executor::PeriodicTask>> tasks(kTasks);
+        std::vector<size_t>                                  counts(kTasks, 0U);
+
+        for (size_t i{0U}; i < kTasks; ++i) {
+            tasks[i] = executor.createPeriodicTask(
+                5ms,
+                [&tasks, &counts, i]() {
+                    if (++counts[i] == kCallCount) {
+                        tasks[i]->stop();
+                    }
+                },
+                false);
+
+            tasks[i]->start();
+        }
+
+        // a stopped and a runNow()-triggered task alongside
+        auto idle = executor.createPeriodicTask(1h, []() {}, false);
+        idle->start();
+        idle->stop();
+
+        size_t soon = 0U;
+
+        std::shared_ptr<Executor::PeriodicTask> late = executor.createPeriodicTask(1h, [&late, &soon]() {
+            ++soon;
+            late->stop();
+        });
+        late->start(1h);
+        late->runNow();
+
+        ASSERT_NO_THROW(executor.run(2U));
+
+        EXPECT_TRUE(std::ranges::all_of(counts, [](const size_t count) {
+            return count == kCallCount;
+        }));
+        EXPECT_EQ(soon, 1U);
+    }
+
+    // two tasks of one wheel run at the same time: the first one waits for the second one to have run
+    Executor executor{Executor::Options{.periodicTimer = Executor::PeriodicTimer::kTimerWheel}};
+
+    std::atomic<bool> waited{false};
+    std::atomic<bool> overlapped{false};
+
+    std::shared_ptr<Executor::PeriodicTask> slow;
+    std::shared_ptr<Executor::PeriodicTask> fast;
+
+    slow = executor.createPeriodicTask(
+        1ms,
+        [&]() {
+            const auto giveUp = std::chrono::steady_clock::now() + 2s;
+
+            while (!waited.load() && std::chrono::steady_clock::now() < giveUp) {
+                std::this_thread::sleep_for(100us);
+            }
+
+            overlapped = waited.load();
+            slow->stop();
+        },
+        false);
+
+    fast = executor.createPeriodicTask(
+        1ms,
+        [&]() {
+            waited = true;
+            fast->stop();
+        },
+        false);
+
+    slow->start();
+    fast->start(5ms);
+
+    ASSERT_NO_THROW(executor.run(1U));
+    EXPECT_TRUE(overlapped.load());
+}
+
+TEST(WatchdogManagerTest, intervalSlots)
+{
+    WatchdogManager manager{2U};
+
+    const auto first  = manager.startInterval(1h);
+    const auto second = manager.startInterval(1h);
+
+    ASSERT_NE(first, WatchdogManager::kNoSlot);
+    ASSERT_NE(second, WatchdogManager::kNoSlot);
+    EXPECT_NE(first, second);
+    EXPECT_TRUE(manager.check());
+
+    // no slot left: the interval is still watched, on the overflow list, and running out is no failure
+    const auto overflowed = manager.startInterval(1h);
+    EXPECT_GE(overflowed, 2U);
+    EXPECT_NE(overflowed, WatchdogManager::kNoSlot);
+    EXPECT_TRUE(manager.check());
+
+    const auto overdueOverflow = manager.startInterval(0ns);
+    std::this_thread::sleep_for(1ms);
+    EXPECT_FALSE(manager.check());
+
+    manager.finishInterval(overdueOverflow);
+    EXPECT_TRUE(manager.check());
+    EXPECT_EQ(manager.startInterval(1h), overdueOverflow);  // recycled
+    manager.finishInterval(overdueOverflow);
+    manager.finishInterval(overflowed);
+    EXPECT_EQ(manager.overflowed(), 3U);
+
+    manager.finishInterval(first);
+
+    const auto overdue = manager.startInterval(0ns);
+
+    EXPECT_EQ(overdue, first);  // recycled
+    std::this_thread::sleep_for(1ms);
+    EXPECT_FALSE(manager.check());
+
+    manager.finishInterval(overdue);
+    manager.finishInterval(second);
+    manager.finishInterval(WatchdogManager::kNoSlot);
+    EXPECT_TRUE(manager.check());
+}
+
+TEST(WatchdogManagerTest, concurrentIntervalsGetDistinctSlots)
+{
+    constexpr size_t kThreads = 4U;
+    constexpr size_t kRounds  = 10'000U;
+    constexpr size_t kHeld    = 8U;
+
+    WatchdogManager                manager{kThreads * kHeld};
+    std::vector<std::atomic<bool>> taken(kThreads * kHeld);
+    std::atomic<size_t>            collisions{0U};
+    std::vector<std::thread>       threads;
+
+    for (size_t t{0U}; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            std::array<WatchdogManager::Slot, kHeld> held{};
+
+            for (size_t round{0U}; round < kRounds; ++round) {
+                for (auto& slot : held) {
+                    slot = manager.startInterval(1h);
+
+                    if (slot == WatchdogManager::kNoSlot || taken[slot].exchange(true)) {
+                        collisions.fetch_add(1U);
+                    }
+                }
+
+                // freed slots go to this thread's free list, the others take them from there when theirs run dry
+                for (auto& slot : held) {
+                    if (slot != WatchdogManager::kNoSlot) {
+                        taken[slot].store(false);
+                        manager.finishInterval(slot);
+                    }
+                }
+
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(collisions.load(), 0U);
+    EXPECT_TRUE(manager.check());
+}
+
+TEST(LatencyHistogramTest, bucketsAndPercentiles)
+{
+    EXPECT_EQ(HistogramSnapshot::bucketOf(-1ns), 0U);
+    EXPECT_EQ(HistogramSnapshot::bucketOf(0ns), 0U);
+    EXPECT_EQ(HistogramSnapshot::bucketOf(1ns), 1U);
+    EXPECT_EQ(HistogramSnapshot::bucketOf(1023ns), 10U);
+    EXPECT_EQ(HistogramSnapshot::bucketOf(1024ns), 11U);
+    EXPECT_EQ(HistogramSnapshot::bucketOf(24h), HistogramSnapshot::kBuckets - 1U);
+    EXPECT_EQ(HistogramSnapshot::upperBound(10U), 1024ns);
+
+    LatencyHistogram histogram;
+
+    EXPECT_EQ(histogram.snapshot().percentile(0.5), 0ns);
+
+    for (int i{0}; i < 90; ++i) {
+        histogram.record(100ns);
+    }
+
+    for (int i{0}; i < 10; ++i) {
+        histogram.record(1ms);
+    }
+
+    const auto snapshot = histogram.snapshot();
+
+    EXPECT_EQ(snapshot.count, 100U);
+    EXPECT_EQ(snapshot.max, 1ms);
+    EXPECT_EQ(snapshot.mean(), (90 * 100ns + 10 * 1ms) / 100);
+    EXPECT_EQ(snapshot.percentile(0.5), 128ns);
+    EXPECT_EQ(snapshot.percentile(0.9), 128ns);
+    EXPECT_EQ(snapshot.percentile(0.95), 1ms);  // the bucket bound is capped at the maximum
+    EXPECT_EQ(snapshot.percentile(1.0), 1ms);
+}
+
 }  // namespace executor
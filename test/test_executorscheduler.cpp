@@ -0,0 +1,124 @@
+#include "example02/executorscheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexec/execution.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace executor
+{
+
+static_assert(stdexec::scheduler<ExecutorScheduler>);
+
+// The executor runs on a thread of its own, kept busy by an idle periodic task, while the tests wait on sender
+// pipelines with sync_wait().
+class ExecutorSchedulerTest : public testing::TestWithParam<Executor::Backend>
+{
+public:
+    void
+    SetUp() override
+    {
+        keepAlive_ = executor_.createPeriodicTask(
+            10ms,
+            []() {
+            },
+            false);
+        keepAlive_->start();
+
+        runner_ = std::thread{[this]() {
+            executor_.run(2U);
+        }};
+    }
+
+    void
+    TearDown() override
+    {
+        keepAlive_->stop();
+        runner_.join();
+    }
+
+protected:
+    Executor                                executor_{Executor::Options{.backend = GetParam(), .shardsCount = 2U}};
+    std::shared_ptr<Executor::PeriodicTask> keepAlive_;
+    std::thread                             runner_;
+};
+
+TEST_P(ExecutorSchedulerTest, pipelinesCompleteOnExecutorThreads)
+{
+    auto scheduler = executor_.get_scheduler();
+
+    const auto square = [](int i) {
+        return std::make_pair(i * i, std::this_thread::get_id());
+    };
+
+    auto work = stdexec::when_all(stdexec::schedule(scheduler) | stdexec::then([&square]() {
+                                      return square(1);
+                                  }),
+                                  stdexec::schedule(scheduler.with_priority(Executor::Priority::kCritical))
+                                      | stdexec::then([&square]() {
+                                            return square(2);
+                                        }),
+                                  stdexec::schedule(scheduler.with_timeout(1s)) | stdexec::then([&square]() {
+                                      return square(3);
+                                  }));
+
+    auto [a, b, c] = stdexec::sync_wait(std::move(work)).value();
+
+    EXPECT_EQ(a.first, 1);
+    EXPECT_EQ(b.first, 4);
+    EXPECT_EQ(c.first, 9);
+
+    for (const auto& id : {a.second, b.second, c.second}) {
+        EXPECT_NE(id, std::this_thread::get_id());
+    }
+}
+
+TEST_P(ExecutorSchedulerTest, timedScheduling)
+{
+    auto scheduler = executor_.get_scheduler();
+
+    const auto start = Executor::Clock::now();
+
+    EXPECT_TRUE(stdexec::sync_wait(scheduler.schedule_after(20ms)).has_value());
+    EXPECT_GE(Executor::Clock::now() - start, 20ms);
+
+    const auto deadline = Executor::Clock::now() + 20ms;
+
+    auto [now] = stdexec::sync_wait(scheduler.schedule_at(deadline) | stdexec::then([]() {
+                                        return Executor::Clock::now();
+                                    }))
+                     .value();
+
+    EXPECT_GE(now, deadline);
+}
+
+TEST_P(ExecutorSchedulerTest, stopRequestCompletesStopped)
+{
+    auto scheduler = executor_.get_scheduler();
+
+    std::atomic<bool> ran{false};
+
+    // the failing sibling makes when_all request a stop, the pending timer then completes with set_stopped()
+    auto work = stdexec::when_all(scheduler.schedule_after(50ms) | stdexec::then([&ran]() {
+                                      ran.store(true);
+                                  }),
+                                  stdexec::just() | stdexec::then([]() {
+                                      throw std::runtime_error{""};
+                                  }));
+
+    EXPECT_THROW(stdexec::sync_wait(std::move(work)), std::runtime_error);
+    EXPECT_FALSE(ran.load());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         ExecutorSchedulerTest,
+                         testing::Values(Executor::Backend::kAsio,
+                                         Executor::Backend::kWorkStealing,
+                                         Executor::Backend::kSharded));
+
+}  // namespace executor